@@ -0,0 +1,29 @@
+/**
+ ****************************************************************************************************
+ * @file        emotion_frames.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       表情动画集
+ *              构建时由 assets/emotions/<name>.gif 经 tools/anim_pack.py 生成各序列的动画包,
+ *              再经 tools/anim_bundle.py 合并为动画集(序列间相同的帧只存一份),
+ *              通过 target_add_binary_data 嵌入固件(见BSP的CMakeLists.txt)
+ *              用 anim_bundle_find(emotion_anims, EMOTION_ANIMS_SIZE, "sad_loop", ...) 按名字取得动画包
+ ****************************************************************************************************
+ */
+
+#ifndef __EMOTION_FRAMES_H
+#define __EMOTION_FRAMES_H
+
+#include <stdint.h>
+
+
+#define FRAME_WIDTH             240         /* 帧宽度 */
+#define FRAME_HEIGHT            240         /* 帧高度 */
+
+/* 嵌入固件的动画集 */
+extern const uint8_t emotion_anims[] asm("_binary_anim_bin_start");
+extern const uint8_t emotion_anims_end[] asm("_binary_anim_bin_end");
+
+#define EMOTION_ANIMS_SIZE      ((uint32_t)(emotion_anims_end - emotion_anims))  /* 动画集长度 */
+
+#endif
@@ -1,58 +1,98 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_system.h"
+#include "esp_attr.h"
 #include "lcd.h"
 #include "spi.h"
 #include "iic.h"
 #include "xl9555.h"
 #include "led.h"
+#include "anim.h"
+#include "anim_pace.h"
 
 // LED控制相关定义
 #define MY_LED_ON()    LED(1)     // 打开LED
 #define MY_LED_OFF()   LED(0)     // 关闭LED
 
-// 表情动画帧头文件
-#include "excited_in_frames.h"
-#include "excited_loop_frames.h"
-#include "excited_out_frames.h"
-#include "sad_in_frames.h"
-#include "sad_loop_frames.h"
-#include "sad_out_frames.h"
+// 表情动画集（构建时由GIF生成并嵌入固件）
+#include "emotion_frames.h"
+
+#define FRAME_CHUNK_PIXELS  2048    // 每次SPI传输的像素数(4KB)
+
+// 帧解码缓存（内部RAM，可直接用于SPI DMA）
+static DMA_ATTR uint16_t frame_chunk[FRAME_CHUNK_PIXELS];
+
+// 帧节奏与统计（所有表情连续排期）
+static anim_pace_t pace;
 
 /**
- * @brief 分块写入一帧 RGB565 数据，防止 SPI 传输过长报错
+ * @brief 绘制一帧：每个脏矩形设置一次窗口，再分块解码写入 RGB565 数据，防止 SPI 传输过长报错
  */
-void lcd_draw_frame(const uint16_t *frame)
+void lcd_draw_frame(const anim_pack_t *pack, uint16_t index)
 {
-    const size_t chunk_size = 4096;
-    size_t total_size = FRAME_WIDTH * FRAME_HEIGHT * 2;
-    const uint8_t *data = (const uint8_t *)frame;
+    anim_decoder_t dec;
+    anim_rect_t rect;
+    size_t len;
 
-    for (size_t offset = 0; offset < total_size; offset += chunk_size)
+    if (anim_decoder_start(&dec, pack, index) != 0)
     {
-        size_t len = (offset + chunk_size <= total_size) ? chunk_size : (total_size - offset);
-        lcd_write_data(data + offset, len);
+        return;
+    }
+
+    while (anim_next_rect(&dec, &rect) == 0)
+    {
+        lcd_set_window(rect.x, rect.y, rect.x + rect.w - 1, rect.y + rect.h - 1);
+
+        while ((len = anim_decode(&dec, frame_chunk, FRAME_CHUNK_PIXELS)) > 0)
+        {
+            lcd_write_data((const uint8_t *)frame_chunk, len * 2);
+        }
     }
 }
 
 /**
  * @brief 播放一段动画
  * 
- * @param frames      帧指针数组
- * @param frame_count 帧数
- * @param delay_ms    每帧延时(ms)
+ * @param name        动画名（动画集中的包名，如 "sad_loop"），每帧显示时长取自动画包
  * @param loop        是否循环播放
  * @param loop_count  循环次数（仅在 loop 为 true 时有效）
  */
-void play_expression(const uint16_t **frames, int frame_count, int delay_ms, bool loop, int loop_count)
+void play_expression(const char *name, bool loop, int loop_count)
 {
+    const uint8_t *anim;
+    uint32_t size;
+    anim_pack_t pack;
     int current_loop = 0;
+    uint16_t index;
+    uint16_t duration;
+    uint16_t flags;
+    uint8_t skippable;
+
+    if (anim_bundle_find(emotion_anims, EMOTION_ANIMS_SIZE, name, &anim, &size) != 0 ||
+        anim_pack_open(&pack, anim, size) != 0)
+    {
+        printf("动画包解析失败\n");
+        return;
+    }
+
     do {
-        for (int i = 0; i < frame_count; i++)
+        for (int i = 0; i < pack.frame_count; i++)
         {
-            lcd_set_window(0, 0, FRAME_WIDTH - 1, FRAME_HEIGHT - 1);
-            lcd_draw_frame(frames[i]);
-            vTaskDelay(pdMS_TO_TICKS(delay_ms));
+            // 循环的第二遍起，首帧用回环差分帧（末帧 -> 首帧）
+            index = (i == 0 && current_loop > 0 && (pack.flags & ANIM_FLAG_LOOP)) ? pack.frame_count : i;
+
+            // 落后时只有下一帧是关键帧才能跳过本帧（差分帧依赖上一帧的画面）
+            skippable = (i + 1 < pack.frame_count && anim_frame_meta(&pack, i + 1, &duration, &flags) == 0 &&
+                         (flags & ANIM_FRAME_KEY));
+            anim_frame_meta(&pack, index, &duration, &flags);
+
+            if (anim_pace_skip(&pace, duration, skippable))
+            {
+                continue;
+            }
+
+            lcd_draw_frame(&pack, index);
+            anim_pace_wait(&pace, duration);    // 按绝对时刻等待，绘制耗时不累积
         }
         if (loop) {
             current_loop++;
@@ -95,6 +135,8 @@ void app_main(void)
 
     // LED闪烁任务句柄
     TaskHandle_t led_task_handle = NULL;
+
+    anim_pace_start(&pace);
     
     while (1)
     {
@@ -105,12 +147,12 @@ void app_main(void)
             led_task_handle = NULL;
         }
         
-        play_expression(excited_in_frames, EXCITED_IN_FRAME_COUNT, 100, false, 0);
-        play_expression(excited_loop_frames, EXCITED_LOOP_FRAME_COUNT, 100, true, 3);  // 循环3次
+        play_expression("excited_in", false, 0);
+        play_expression("excited_loop", true, 3);  // 循环3次
 
-        // 等待 3 秒后退出循环
-        vTaskDelay(pdMS_TO_TICKS(300));
-        play_expression(excited_out_frames, EXCITED_OUT_FRAME_COUNT, 100, false, 0);
+        // 停顿 300ms 后播放退场
+        anim_pace_pause(&pace, 300);
+        play_expression("excited_out", false, 0);
 
         // 😢 难过表情 - LED闪烁
         // 创建LED闪烁任务
@@ -123,11 +165,15 @@ void app_main(void)
             &led_task_handle
         );
         
-        play_expression(sad_in_frames, SAD_IN_FRAME_COUNT, 100, false, 0);
-        play_expression(sad_loop_frames, SAD_LOOP_FRAME_COUNT, 100, true, 3);  // 循环3次
+        play_expression("sad_in", false, 0);
+        play_expression("sad_loop", true, 3);  // 循环3次
+
+        // 停顿 300ms 后播放退场
+        anim_pace_pause(&pace, 300);
+        play_expression("sad_out", false, 0);
 
-        // 等待 3 秒后退出循环
-        vTaskDelay(pdMS_TO_TICKS(300));
-        play_expression(sad_out_frames, SAD_OUT_FRAME_COUNT, 100, false, 0);
+        printf("动画统计: 显示%lu帧, 超时%lu帧, 丢弃%lu帧, 最大落后%ldus\n",
+               (unsigned long)pace.frames, (unsigned long)pace.late,
+               (unsigned long)pace.dropped, (long)pace.max_lag_us);
     }
 }
@@ -0,0 +1,630 @@
+/**
+ ****************************************************************************************************
+ * @file        anim.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       表情动画压缩容器 解码代码
+ ****************************************************************************************************
+ */
+
+#include <string.h>
+#include "anim.h"
+
+
+#define ANIM_MIN(a, b)          ((a) < (b) ? (a) : (b))
+
+/**
+ * @brief       读取小端16位数
+ * @param       p : 数据地址
+ * @retval      读取到的值
+ */
+static inline uint16_t anim_rd16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/**
+ * @brief       读取小端32位数
+ * @param       p : 数据地址
+ * @retval      读取到的值
+ */
+static inline uint32_t anim_rd32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief       根据包头计算包头+帧索引表+帧信息表+调色板的总长度
+ * @note        流式读取时先读ANIM_HEADER_SIZE字节,再按此长度读出其余索引信息
+ * @param       header : 包头(至少ANIM_HEADER_SIZE字节)
+ * @retval      索引信息长度,0表示不是动画包
+ */
+uint32_t anim_head_size(const uint8_t *header)
+{
+    uint32_t entries;
+
+    if (anim_rd32(header) != ANIM_MAGIC)
+    {
+        return 0;
+    }
+
+    entries = anim_rd16(header + 12) + ((anim_rd16(header + 6) & ANIM_FLAG_LOOP) ? 1 : 0);
+
+    return (ANIM_HEADER_SIZE + entries * (ANIM_FRAME_ENTRY_SIZE + ANIM_FRAME_META_SIZE) + anim_rd16(header + 14) * 2 + 3) & ~3UL;
+}
+
+/**
+ * @brief       只根据索引信息解析动画包(帧数据不在内存中,如从SD卡流式读取)
+ * @note        此时pack->base只包含索引信息,帧数据需用anim_frame_info()定位后自行读取,
+ *              再用anim_decoder_start_frame()解码
+ * @param       pack      : 动画包描述
+ * @param       head      : 包头+帧索引表+帧信息表+调色板
+ * @param       head_size : head的长度
+ * @param       pack_size : 整个动画包的长度
+ * @retval      0,成功
+ *              1,包头不完整或魔数错误
+ *              2,版本或编码方式不支持
+ *              3,帧索引表或调色板越界
+ */
+uint8_t anim_pack_open_head(anim_pack_t *pack, const uint8_t *head, uint32_t head_size, uint32_t pack_size)
+{
+    uint16_t i;
+    uint16_t entries;
+    uint16_t max_colors;
+    uint32_t offset;
+    uint32_t len;
+
+    if (head == NULL || head_size < ANIM_HEADER_SIZE || anim_rd32(head) != ANIM_MAGIC)
+    {
+        return 1;
+    }
+
+    if (head[4] != ANIM_VERSION)
+    {
+        return 2;
+    }
+
+    switch (head[5])
+    {
+        case ANIM_CODEC_RLE16:
+            max_colors = 0;
+            break;
+
+        case ANIM_CODEC_PAL8:
+            max_colors = 256;
+            break;
+
+        case ANIM_CODEC_PAL4:
+            max_colors = 16;
+            break;
+
+        default:
+            return 2;
+    }
+
+    pack->base = head;
+    pack->size = pack_size;
+    pack->codec = head[5];
+    pack->flags = anim_rd16(head + 6);
+    pack->width = anim_rd16(head + 8);
+    pack->height = anim_rd16(head + 10);
+    pack->frame_count = anim_rd16(head + 12);
+    pack->palette_count = anim_rd16(head + 14);
+    pack->palette = NULL;
+
+    entries = pack->frame_count + ((pack->flags & ANIM_FLAG_LOOP) ? 1 : 0);
+    offset = ANIM_HEADER_SIZE + (uint32_t)entries * (ANIM_FRAME_ENTRY_SIZE + ANIM_FRAME_META_SIZE);  /* 调色板紧跟帧信息表 */
+
+    if (pack->palette_count > max_colors || (max_colors && pack->palette_count == 0))
+    {
+        return 3;
+    }
+
+    if (offset + (uint32_t)pack->palette_count * 2 > head_size)
+    {
+        return 3;
+    }
+
+    if (pack->palette_count)
+    {
+        if (((uintptr_t)head & 1) != 0)                                     /* 调色板按uint16_t访问,包起始地址至少2字节对齐 */
+        {
+            return 3;
+        }
+
+        pack->palette = (const uint16_t *)(head + offset);                  /* 包起始4字节对齐,调色板亦对齐 */
+    }
+
+    for (i = 0; i < entries; i++)                           /* 检查每一帧都落在包内 */
+    {
+        offset = anim_rd32(head + ANIM_HEADER_SIZE + i * ANIM_FRAME_ENTRY_SIZE);
+        len = anim_rd32(head + ANIM_HEADER_SIZE + i * ANIM_FRAME_ENTRY_SIZE + 4);
+
+        if (offset > pack_size || len > pack_size - offset || len < ANIM_FRAME_HEADER_SIZE)
+        {
+            return 3;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief       解析完整位于内存中的动画包
+ * @param       pack : 动画包描述
+ * @param       data : 动画包数据
+ * @param       size : 动画包大小
+ * @retval      同anim_pack_open_head()
+ */
+uint8_t anim_pack_open(anim_pack_t *pack, const uint8_t *data, uint32_t size)
+{
+    return anim_pack_open_head(pack, data, size, size);
+}
+
+/**
+ * @brief       获取某一帧在包内的位置
+ * @param       pack   : 动画包描述
+ * @param       index  : 帧序号,带ANIM_FLAG_LOOP时frame_count表示回环帧
+ * @param       offset : 帧数据偏移(相对包起始)
+ * @param       size   : 帧数据长度
+ * @retval      0,成功;1,帧序号越界
+ */
+uint8_t anim_frame_info(const anim_pack_t *pack, uint16_t index, uint32_t *offset, uint32_t *size)
+{
+    const uint8_t *entry;
+    uint16_t entries;
+
+    entries = pack->frame_count + ((pack->flags & ANIM_FLAG_LOOP) ? 1 : 0);
+
+    if (index >= entries)
+    {
+        return 1;
+    }
+
+    entry = pack->base + ANIM_HEADER_SIZE + index * ANIM_FRAME_ENTRY_SIZE;
+    *offset = anim_rd32(entry);
+    *size = anim_rd32(entry + 4);
+
+    return 0;
+}
+
+/**
+ * @brief       获取某一帧的显示时长和帧标志
+ * @param       pack     : 动画包描述
+ * @param       index    : 帧序号,带ANIM_FLAG_LOOP时frame_count表示回环帧
+ * @param       duration : 显示时长(ms)
+ * @param       flags    : 帧标志(ANIM_FRAME_KEY等)
+ * @retval      0,成功;1,帧序号越界
+ */
+uint8_t anim_frame_meta(const anim_pack_t *pack, uint16_t index, uint16_t *duration, uint16_t *flags)
+{
+    const uint8_t *meta;
+    uint16_t entries;
+
+    entries = pack->frame_count + ((pack->flags & ANIM_FLAG_LOOP) ? 1 : 0);
+
+    if (index >= entries)
+    {
+        return 1;
+    }
+
+    meta = pack->base + ANIM_HEADER_SIZE + entries * ANIM_FRAME_ENTRY_SIZE + index * ANIM_FRAME_META_SIZE;
+    *duration = anim_rd16(meta);
+    *flags = anim_rd16(meta + 2);
+
+    return 0;
+}
+
+/**
+ * @brief       开始解码一段已读入内存的帧数据
+ * @param       dec   : 解码器
+ * @param       pack  : 动画包描述(提供编码方式和调色板)
+ * @param       frame : 帧数据
+ * @param       size  : 帧数据长度
+ * @retval      0,成功;1,帧数据不完整
+ */
+uint8_t anim_decoder_start_frame(anim_decoder_t *dec, const anim_pack_t *pack, const uint8_t *frame, uint32_t size)
+{
+    if (frame == NULL || size < ANIM_FRAME_HEADER_SIZE)
+    {
+        return 1;
+    }
+
+    dec->frame_end = frame + size;
+    dec->rects_left = anim_rd16(frame);
+    dec->frame_flags = anim_rd16(frame + 2);
+    dec->next = frame + ANIM_FRAME_HEADER_SIZE;
+    dec->src = dec->next;
+    dec->end = dec->next;
+    dec->left = 0;
+    dec->palette = pack->palette;
+    dec->palette_max = pack->palette_count ? pack->palette_count - 1 : 0;
+    dec->codec = pack->codec;
+    dec->count = 0;
+    dec->pixel = 0;
+    dec->literal = 0;
+    dec->nibble = 0;
+
+    return 0;
+}
+
+/**
+ * @brief       开始解码某一帧(动画包需完整位于内存中)
+ * @param       dec   : 解码器
+ * @param       pack  : 动画包描述
+ * @param       index : 帧序号,带ANIM_FLAG_LOOP时frame_count表示回环帧
+ * @retval      0,成功;1,帧序号越界
+ */
+uint8_t anim_decoder_start(anim_decoder_t *dec, const anim_pack_t *pack, uint16_t index)
+{
+    uint32_t offset;
+    uint32_t size;
+
+    if (anim_frame_info(pack, index, &offset, &size) != 0)
+    {
+        return 1;
+    }
+
+    return anim_decoder_start_frame(dec, pack, pack->base + offset, size);
+}
+
+/**
+ * @brief       取出下一个脏矩形,之后用anim_decode()解码该矩形的像素(按行优先)
+ * @note        帧数据可能来自SD卡,长度一律与剩余字节数比较,不先算出可能越界的指针;
+ *              该矩形最多解码出w*h个像素,编码数据多出的部分不会写入调用者的缓存
+ * @param       dec  : 解码器
+ * @param       rect : 矩形位置(相对帧左上角)
+ * @retval      0,成功;1,该帧已没有更多矩形(或矩形头/数据长度越界)
+ */
+uint8_t anim_next_rect(anim_decoder_t *dec, anim_rect_t *rect)
+{
+    const uint8_t *p = dec->next;
+    uint32_t len;
+
+    if (dec->rects_left == 0 || (size_t)(dec->frame_end - p) < ANIM_RECT_HEADER_SIZE)
+    {
+        return 1;
+    }
+
+    len = anim_rd32(p + 8);
+
+    if (len > (size_t)(dec->frame_end - p) - ANIM_RECT_HEADER_SIZE)
+    {
+        return 1;
+    }
+
+    rect->x = anim_rd16(p);
+    rect->y = anim_rd16(p + 2);
+    rect->w = anim_rd16(p + 4);
+    rect->h = anim_rd16(p + 6);
+
+    dec->src = p + ANIM_RECT_HEADER_SIZE;
+    dec->end = dec->src + len;
+    dec->left = (uint32_t)rect->w * rect->h;
+    dec->next = dec->end;
+    dec->rects_left--;
+    dec->count = 0;
+    dec->nibble = 0;
+
+    return 0;
+}
+
+/**
+ * @brief       8位调色板索引查表展开为RGB565
+ * @note        ESP32-S3的PIE向量指令没有查表(gather)操作,这里每次展开4个像素,
+ *              先一次取出4个索引再连续写出,让编译器生成无依赖的装载/存储流水;
+ *              索引先钳位到max(单条MINU指令),调色板不足256色时也不会读出界
+ * @param       dst     : 目标缓存
+ * @param       idx     : 索引
+ * @param       n       : 像素数
+ * @param       palette : 调色板
+ * @param       max     : 最大有效索引(颜色数-1)
+ * @retval      无
+ */
+void anim_expand_pal8(uint16_t *dst, const uint8_t *idx, size_t n, const uint16_t *palette, uint8_t max)
+{
+    uint8_t a, b, c, d;
+
+    while (n >= 4)
+    {
+        a = ANIM_MIN(idx[0], max);
+        b = ANIM_MIN(idx[1], max);
+        c = ANIM_MIN(idx[2], max);
+        d = ANIM_MIN(idx[3], max);
+        dst[0] = palette[a];
+        dst[1] = palette[b];
+        dst[2] = palette[c];
+        dst[3] = palette[d];
+        idx += 4;
+        dst += 4;
+        n -= 4;
+    }
+
+    while (n--)
+    {
+        a = *idx++;
+        *dst++ = palette[ANIM_MIN(a, max)];
+    }
+}
+
+/**
+ * @brief       4位调色板索引查表展开为RGB565(每字节2个索引,高4位在前)
+ * @param       dst     : 目标缓存
+ * @param       idx     : 索引,从字节边界开始
+ * @param       n       : 像素数
+ * @param       palette : 调色板
+ * @param       max     : 最大有效索引(颜色数-1)
+ * @retval      无
+ */
+void anim_expand_pal4(uint16_t *dst, const uint8_t *idx, size_t n, const uint16_t *palette, uint8_t max)
+{
+    uint8_t a, b;
+
+    while (n >= 4)
+    {
+        a = idx[0];
+        b = idx[1];
+        dst[0] = palette[ANIM_MIN(a >> 4, max)];
+        dst[1] = palette[ANIM_MIN(a & 0x0F, max)];
+        dst[2] = palette[ANIM_MIN(b >> 4, max)];
+        dst[3] = palette[ANIM_MIN(b & 0x0F, max)];
+        idx += 2;
+        dst += 4;
+        n -= 4;
+    }
+
+    while (n >= 2)
+    {
+        a = *idx++;
+        dst[0] = palette[ANIM_MIN(a >> 4, max)];
+        dst[1] = palette[ANIM_MIN(a & 0x0F, max)];
+        dst += 2;
+        n -= 2;
+    }
+
+    if (n)
+    {
+        *dst = palette[ANIM_MIN(*idx >> 4, max)];
+    }
+}
+
+/**
+ * @brief       解码字面量中的n个像素
+ * @param       dec : 解码器
+ * @param       dst : 目标缓存
+ * @param       n   : 像素数(不超过当前字面量剩余像素数)
+ * @retval      无
+ */
+static void anim_decode_literal(anim_decoder_t *dec, uint16_t *dst, size_t n)
+{
+    size_t whole;
+    uint8_t last = (n == dec->count);                       /* 本次解码到字面量末尾 */
+
+    switch (dec->codec)
+    {
+        case ANIM_CODEC_RLE16:
+            memcpy(dst, dec->src, n * 2);
+            dec->src += n * 2;
+            break;
+
+        case ANIM_CODEC_PAL8:
+            anim_expand_pal8(dst, dec->src, n, dec->palette, dec->palette_max);
+            dec->src += n;
+            break;
+
+        default:                                            /* ANIM_CODEC_PAL4 */
+            if (dec->nibble && n)                           /* 上次停在字节中间,先补齐低4位 */
+            {
+                *dst++ = dec->palette[ANIM_MIN(*dec->src & 0x0F, dec->palette_max)];
+                dec->src++;
+                dec->nibble = 0;
+                n--;
+            }
+
+            anim_expand_pal4(dst, dec->src, n, dec->palette, dec->palette_max);
+            whole = n / 2;
+            dec->src += whole;
+
+            if (n & 1)                                      /* 停在字节中间 */
+            {
+                if (last)                                   /* 字面量结束,跳过填充的低4位 */
+                {
+                    dec->src++;
+                }
+                else
+                {
+                    dec->nibble = 1;
+                }
+            }
+            break;
+    }
+}
+
+/**
+ * @brief       计算一个记号(含记号字节)占用的数据长度
+ * @param       dec : 解码器
+ * @param       c   : 记号字节
+ * @retval      字节数
+ */
+static uint32_t anim_token_size(const anim_decoder_t *dec, uint8_t c)
+{
+    uint32_t n;
+
+    if ((c & 0x80) == 0)                                    /* 字面量:后跟(c+1)个像素 */
+    {
+        n = (uint32_t)c + 1;
+
+        switch (dec->codec)
+        {
+            case ANIM_CODEC_RLE16:
+                return 1 + n * 2;
+
+            case ANIM_CODEC_PAL8:
+                return 1 + n;
+
+            default:                                        /* ANIM_CODEC_PAL4 */
+                return 1 + (n + 1) / 2;
+        }
+    }
+
+    return ((c & 0x40) ? 2 : 1) + (dec->codec == ANIM_CODEC_RLE16 ? 2 : 1);    /* 游程:长度字节+1个像素 */
+}
+
+/**
+ * @brief       解码若干像素到目标缓存
+ * @note        一个游程/字面量可以跨越多次调用,因此可直接解码到SPI分块缓存中;
+ *              调色板格式在这里完成查表,输出始终为RGB565;
+ *              读取记号前先确认它的数据完整地位于矩形数据内,不完整时按矩形结束处理
+ * @param       dec        : 解码器
+ * @param       dst        : 目标缓存(RGB565,面板字节序)
+ * @param       max_pixels : 最多解码的像素数
+ * @retval      实际解码的像素数,小于max_pixels表示当前矩形已解码完毕
+ */
+size_t anim_decode(anim_decoder_t *dec, uint16_t *dst, size_t max_pixels)
+{
+    size_t out = 0;
+    size_t n;
+    uint8_t c;
+
+    if (max_pixels > dec->left)
+    {
+        max_pixels = dec->left;                             /* 不超出矩形声明的大小 */
+    }
+
+    while (out < max_pixels)
+    {
+        if (dec->count == 0)                                /* 读取下一个记号 */
+        {
+            if (dec->src >= dec->end)
+            {
+                break;                                      /* 矩形数据结束 */
+            }
+
+            c = *dec->src;
+
+            if (anim_token_size(dec, c) > (size_t)(dec->end - dec->src))
+            {
+                dec->src = dec->end;                        /* 数据被截断,丢弃该矩形的其余部分 */
+                break;
+            }
+
+            dec->src++;
+
+            if ((c & 0x80) == 0)                            /* 字面量 */
+            {
+                dec->count = (uint32_t)c + 1;
+                dec->literal = 1;
+                dec->nibble = 0;
+            }
+            else
+            {
+                if (c & 0x40)                               /* 长游程 */
+                {
+                    dec->count = ((((uint32_t)c & 0x3F) << 8) | *dec->src++) + 1;
+                }
+                else                                        /* 短游程 */
+                {
+                    dec->count = ((uint32_t)c & 0x3F) + 1;
+                }
+
+                if (dec->codec == ANIM_CODEC_RLE16)
+                {
+                    dec->pixel = anim_rd16(dec->src);
+                    dec->src += 2;
+                }
+                else
+                {
+                    c = *dec->src++;
+                    dec->pixel = dec->palette[ANIM_MIN(c, dec->palette_max)];
+                }
+
+                dec->literal = 0;
+            }
+        }
+
+        n = max_pixels - out;
+
+        if (n > dec->count)
+        {
+            n = dec->count;
+        }
+
+        if (dec->literal)
+        {
+            anim_decode_literal(dec, dst + out, n);
+        }
+        else
+        {
+            for (size_t i = 0; i < n; i++)
+            {
+                dst[out + i] = dec->pixel;
+            }
+        }
+
+        dec->count -= n;
+        out += n;
+    }
+
+    dec->left -= out;
+
+    return out;
+}
+
+/**
+ * @brief       在动画集中按名字查找动画包
+ * @param       bundle : 动画集起始地址
+ * @param       size   : 动画集长度
+ * @param       name   : 包名,如"sad_loop"
+ * @param       data   : 动画包地址(指向动画集内部,帧数据可能与其它包共享)
+ * @param       len    : 动画包长度
+ * @retval      0,找到
+ *              1,不是有效的动画集
+ *              2,未找到
+ */
+uint8_t anim_bundle_find(const uint8_t *bundle, uint32_t size, const char *name, const uint8_t **data, uint32_t *len)
+{
+    const uint8_t *entry;
+    uint32_t offset;
+    uint32_t n;
+    uint16_t count;
+    uint16_t i;
+
+    if (bundle == NULL || size < ANIM_BUNDLE_HEADER_SIZE || anim_rd32(bundle) != ANIM_BUNDLE_MAGIC ||
+        anim_rd16(bundle + 4) != ANIM_BUNDLE_VERSION || anim_rd32(bundle + 8) > size)
+    {
+        return 1;
+    }
+
+    size = anim_rd32(bundle + 8);
+    count = anim_rd16(bundle + 6);
+
+    if (ANIM_BUNDLE_HEADER_SIZE + (uint32_t)count * ANIM_BUNDLE_ENTRY_SIZE > size)
+    {
+        return 1;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        entry = bundle + ANIM_BUNDLE_HEADER_SIZE + i * ANIM_BUNDLE_ENTRY_SIZE;
+
+        if (strncmp((const char *)entry, name, ANIM_BUNDLE_NAME_SIZE) != 0)
+        {
+            continue;
+        }
+
+        offset = anim_rd32(entry + ANIM_BUNDLE_NAME_SIZE);
+        n = anim_rd32(entry + ANIM_BUNDLE_NAME_SIZE + 4);
+
+        if (offset > size || n > size - offset)
+        {
+            return 1;
+        }
+
+        *data = bundle + offset;
+        *len = n;
+
+        return 0;
+    }
+
+    return 2;
+}
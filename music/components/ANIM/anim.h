@@ -0,0 +1,141 @@
+/**
+ ****************************************************************************************************
+ * @file        anim.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       表情动画压缩容器 解码代码
+ *              动画包(ANIM)由主机端工具 tools/anim_pack.py 生成,帧数据采用游程编码
+ *              每帧由若干脏矩形组成,非关键帧只保存相对上一帧发生变化的区域
+ *              像素可直接保存RGB565,也可保存调色板索引(8位/4位),解码时查表还原为RGB565
+ ****************************************************************************************************
+ * @attention
+ *
+ * 动画包格式(小端):
+ *   0   4字节  魔数 "ANIM"
+ *   4   1字节  版本号(ANIM_VERSION)
+ *   5   1字节  编码方式(ANIM_CODEC_xxx)
+ *   6   2字节  标志(ANIM_FLAG_xxx)
+ *   8   2字节  帧宽度
+ *   10  2字节  帧高度
+ *   12  2字节  帧数量
+ *   14  2字节  调色板颜色数(RLE16时为0)
+ *   16  帧索引表: 帧数量(+1) * {4字节偏移(相对包起始), 4字节长度}
+ *       带ANIM_FLAG_LOOP标志时,最后多出一项"回环帧":从末帧回到首帧的差分
+ *   ... 帧信息表: 帧数量(+1) * {2字节显示时长(ms), 2字节帧标志}
+ *       帧标志与帧数据中的相同,播放时不必读出帧数据即可判断能否跳过
+ *   ... 调色板: 颜色数 * 2字节RGB565(面板字节序),4字节对齐
+ *   ... 帧数据
+ *
+ * 帧数据:
+ *   0   2字节  矩形数量
+ *   2   2字节  帧标志(ANIM_FRAME_KEY表示整帧)
+ *   4   矩形: {2字节x, 2字节y, 2字节w, 2字节h, 4字节编码数据长度, 编码数据}, 依次排列
+ *
+ * 游程编码(像素按面板字节序存放,与原RGB565数组内存布局一致):
+ *   0nnnnnnn                   : 字面量,后跟(n+1)个像素
+ *   10nnnnnn                   : 短游程,后跟1个像素,重复(n+1)次
+ *   11nnnnnn nnnnnnnn          : 长游程,后跟1个像素,重复(n+1)次(n为14位)
+ * 像素的存放方式由编码方式决定:
+ *   ANIM_CODEC_RLE16           : 每像素2字节RGB565
+ *   ANIM_CODEC_PAL8            : 每像素1字节调色板索引
+ *   ANIM_CODEC_PAL4            : 游程像素1字节索引;字面量每字节2个索引,高4位在前
+ *
+ * 动画集(多个动画包合并,由 tools/anim_bundle.py 生成,用于Flash动画分区/固件内置):
+ *   0   4字节  魔数 "ANMB"
+ *   4   2字节  版本号(ANIM_BUNDLE_VERSION)
+ *   6   2字节  动画包数量
+ *   8   4字节  总长度
+ *   12  4字节  保留
+ *   16  目录: 数量 * {24字节包名(以0结尾), 4字节偏移(相对动画集起始), 4字节长度}
+ *   ... 各动画包的包头+帧索引表+调色板
+ *   ... 共享帧数据区:内容相同(编码方式/调色板/帧数据都相同)的帧只存一份,
+ *       各包的帧索引表都指向这里,因此每个包的长度都延伸到动画集末尾
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __ANIM_H
+#define __ANIM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+#define ANIM_MAGIC              0x4D494E41  /* "ANIM" */
+#define ANIM_VERSION            4           /* 动画包版本号 */
+#define ANIM_HEADER_SIZE        16          /* 包头大小 */
+#define ANIM_FRAME_ENTRY_SIZE   8           /* 帧索引表项大小 */
+#define ANIM_FRAME_META_SIZE    4           /* 帧信息表项大小 */
+#define ANIM_FRAME_HEADER_SIZE  4           /* 帧头大小 */
+#define ANIM_RECT_HEADER_SIZE   12          /* 矩形头大小 */
+
+#define ANIM_FLAG_LOOP          0x0001      /* 包含回环帧(末帧->首帧差分) */
+#define ANIM_FRAME_KEY          0x0001      /* 关键帧,不依赖上一帧 */
+
+#define ANIM_CODEC_RLE16        1           /* RGB565游程编码 */
+#define ANIM_CODEC_PAL8         2           /* 8位调色板索引游程编码 */
+#define ANIM_CODEC_PAL4         3           /* 4位调色板索引游程编码 */
+
+#define ANIM_BUNDLE_MAGIC       0x424D4E41  /* "ANMB" */
+#define ANIM_BUNDLE_VERSION     1           /* 动画集版本号 */
+#define ANIM_BUNDLE_HEADER_SIZE 16          /* 动画集头大小 */
+#define ANIM_BUNDLE_ENTRY_SIZE  32          /* 目录项大小 */
+#define ANIM_BUNDLE_NAME_SIZE   24          /* 包名长度 */
+
+/* 动画包描述 */
+typedef struct
+{
+    const uint8_t *base;                    /* 包起始地址 */
+    uint32_t size;                          /* 包大小 */
+    const uint16_t *palette;                /* 调色板(RLE16时为NULL) */
+    uint16_t palette_count;                 /* 调色板颜色数 */
+    uint16_t width;                         /* 帧宽度 */
+    uint16_t height;                        /* 帧高度 */
+    uint16_t frame_count;                   /* 帧数量 */
+    uint16_t flags;                         /* 标志 */
+    uint8_t codec;                          /* 编码方式 */
+} anim_pack_t;
+
+/* 脏矩形(相对帧左上角) */
+typedef struct
+{
+    uint16_t x;
+    uint16_t y;
+    uint16_t w;
+    uint16_t h;
+} anim_rect_t;
+
+/* 帧解码器(可跨SPI分块续解) */
+typedef struct
+{
+    const uint8_t *next;                    /* 下一个矩形头 */
+    const uint8_t *frame_end;               /* 帧数据结束位置 */
+    uint16_t rects_left;                    /* 剩余矩形数 */
+    uint16_t frame_flags;                   /* 帧标志 */
+    const uint8_t *src;                     /* 当前读取位置 */
+    const uint8_t *end;                     /* 当前矩形数据结束位置 */
+    uint32_t left;                          /* 当前矩形还可解码的像素数(w*h),多出的数据丢弃 */
+    const uint16_t *palette;                /* 调色板 */
+    uint8_t palette_max;                    /* 最大有效调色板索引,越界的索引按此值查表 */
+    uint32_t count;                         /* 当前记号剩余像素数 */
+    uint16_t pixel;                         /* 游程像素值 */
+    uint8_t literal;                        /* 1,字面量;0,游程 */
+    uint8_t codec;                          /* 编码方式 */
+    uint8_t nibble;                         /* PAL4字面量:1,下一个索引在当前字节低4位 */
+} anim_decoder_t;
+
+/* 函数声明 */
+uint32_t anim_head_size(const uint8_t *header);                                                 /* 计算包头+索引表+调色板长度 */
+uint8_t anim_pack_open_head(anim_pack_t *pack, const uint8_t *head, uint32_t head_size, uint32_t pack_size);   /* 只根据索引信息解析动画包 */
+uint8_t anim_pack_open(anim_pack_t *pack, const uint8_t *data, uint32_t size);                  /* 解析动画包 */
+uint8_t anim_frame_info(const anim_pack_t *pack, uint16_t index, uint32_t *offset, uint32_t *size);    /* 获取帧在包内的位置 */
+uint8_t anim_frame_meta(const anim_pack_t *pack, uint16_t index, uint16_t *duration, uint16_t *flags);  /* 获取帧显示时长和帧标志 */
+uint8_t anim_decoder_start_frame(anim_decoder_t *dec, const anim_pack_t *pack, const uint8_t *frame, uint32_t size);   /* 开始解码内存中的帧数据 */
+uint8_t anim_decoder_start(anim_decoder_t *dec, const anim_pack_t *pack, uint16_t index);       /* 开始解码某一帧 */
+uint8_t anim_next_rect(anim_decoder_t *dec, anim_rect_t *rect);                                 /* 取出下一个脏矩形 */
+size_t anim_decode(anim_decoder_t *dec, uint16_t *dst, size_t max_pixels);                      /* 解码若干像素 */
+void anim_expand_pal8(uint16_t *dst, const uint8_t *idx, size_t n, const uint16_t *palette, uint8_t max);   /* 8位索引查表展开为RGB565 */
+void anim_expand_pal4(uint16_t *dst, const uint8_t *idx, size_t n, const uint16_t *palette, uint8_t max);   /* 4位索引查表展开为RGB565 */
+uint8_t anim_bundle_find(const uint8_t *bundle, uint32_t size, const char *name, const uint8_t **data, uint32_t *len);   /* 在动画集中按名字查找动画包 */
+
+#endif
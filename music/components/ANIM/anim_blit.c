@@ -0,0 +1,267 @@
+/**
+ ****************************************************************************************************
+ * @file        anim_blit.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       动画帧缩放/居中 代码
+ ****************************************************************************************************
+ */
+
+#include <string.h>
+#include "anim_blit.h"
+
+
+/**
+ * @brief       源坐标映射为目标坐标(向上取整,见anim_blit.h)
+ * @param       c   : 源坐标(0~s)
+ * @param       s   : 源尺寸
+ * @param       d   : 目标尺寸
+ * @retval      目标坐标
+ */
+static int32_t anim_blit_map(uint32_t c, uint32_t s, uint32_t d)
+{
+    return (c * d + s - 1) / s;
+}
+
+/**
+ * @brief       把一维区间映射到屏幕并按窗口裁剪
+ * @param       c, n       : 源区间[c, c+n)
+ * @param       s, d       : 源尺寸,缩放后尺寸
+ * @param       org        : 缩放后帧的起点(屏幕坐标)
+ * @param       lo, hi     : 窗口范围[lo, hi)
+ * @param       out, len   : 屏幕区间
+ * @retval      0,区间非空;1,区间为空
+ */
+static uint8_t anim_blit_span(uint32_t c, uint32_t n, uint32_t s, uint32_t d, int32_t org,
+                              int32_t lo, int32_t hi, uint16_t *out, uint16_t *len)
+{
+    int32_t a = org + anim_blit_map(c, s, d);
+    int32_t b = org + anim_blit_map(c + n, s, d);
+
+    a = (a < lo) ? lo : a;
+    b = (b > hi) ? hi : b;
+
+    if (a >= b)
+    {
+        return 1;
+    }
+
+    *out = (uint16_t)a;
+    *len = (uint16_t)(b - a);
+
+    return 0;
+}
+
+/**
+ * @brief       计算帧到窗口的映射
+ * @param       blit         : 映射
+ * @param       src_w, src_h : 帧尺寸
+ * @param       x, y, w, h   : 屏幕上的窗口
+ * @param       mode         : 缩放方式ANIM_BLIT_xxx
+ * @retval      无
+ */
+void anim_blit_init(anim_blit_t *blit, uint16_t src_w, uint16_t src_h,
+                    uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t mode)
+{
+    uint32_t k;
+
+    memset(blit, 0, sizeof(anim_blit_t));
+    blit->src_w = src_w ? src_w : 1;
+    blit->src_h = src_h ? src_h : 1;
+    blit->clip_x = x;
+    blit->clip_y = y;
+    blit->clip_w = w;
+    blit->clip_h = h;
+    blit->dst_w = blit->src_w;
+    blit->dst_h = blit->src_h;
+
+    switch (mode)
+    {
+        case ANIM_BLIT_INTEGER:
+            k = (w / blit->src_w < h / blit->src_h) ? w / blit->src_w : h / blit->src_h;
+
+            if (k > 1)
+            {
+                blit->dst_w = blit->src_w * k;
+                blit->dst_h = blit->src_h * k;
+            }
+            break;
+
+        case ANIM_BLIT_FIT:
+            if ((uint32_t)w * blit->src_h < (uint32_t)h * blit->src_w)     /* 宽度先顶满 */
+            {
+                blit->dst_w = w;
+                blit->dst_h = (uint32_t)blit->src_h * w / blit->src_w;
+            }
+            else
+            {
+                blit->dst_h = h;
+                blit->dst_w = (uint32_t)blit->src_w * h / blit->src_h;
+            }
+            break;
+
+        case ANIM_BLIT_STRETCH:
+            blit->dst_w = w;
+            blit->dst_h = h;
+            break;
+
+        default:                                            /* ANIM_BLIT_CENTER */
+            break;
+    }
+
+    if (blit->dst_w == 0 || blit->dst_h == 0)
+    {
+        blit->dst_w = blit->src_w;
+        blit->dst_h = blit->src_h;
+    }
+
+    blit->dst_x = x + ((int32_t)w - blit->dst_w) / 2;
+    blit->dst_y = y + ((int32_t)h - blit->dst_h) / 2;
+    blit->scaled = (blit->dst_w != blit->src_w || blit->dst_h != blit->src_h);
+}
+
+/**
+ * @brief       源矩形映射到屏幕(已按窗口裁剪)
+ * @param       blit : 映射
+ * @param       src  : 源矩形(相对帧左上角)
+ * @param       dst  : 屏幕矩形
+ * @retval      0,成功;1,映射后为空(整个在窗口外,或缩小时被略去)
+ */
+uint8_t anim_blit_rect(const anim_blit_t *blit, const anim_rect_t *src, anim_rect_t *dst)
+{
+    if (anim_blit_span(src->x, src->w, blit->src_w, blit->dst_w, blit->dst_x,
+                       blit->clip_x, blit->clip_x + blit->clip_w, &dst->x, &dst->w) ||
+        anim_blit_span(src->y, src->h, blit->src_h, blit->dst_h, blit->dst_y,
+                       blit->clip_y, blit->clip_y + blit->clip_h, &dst->y, &dst->h))
+    {
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief       源的一行对应屏幕的行数(已按窗口裁剪)
+ * @note        放大时为1~k行,缩小时可能为0(该行被略去,但仍须解码以推进解码器)
+ * @param       blit  : 映射
+ * @param       src_y : 源行号
+ * @retval      屏幕行数
+ */
+uint16_t anim_blit_rows(const anim_blit_t *blit, uint16_t src_y)
+{
+    uint16_t y, n;
+
+    if (anim_blit_span(src_y, 1, blit->src_h, blit->dst_h, blit->dst_y,
+                       blit->clip_y, blit->clip_y + blit->clip_h, &y, &n))
+    {
+        return 0;
+    }
+
+    return n;
+}
+
+/**
+ * @brief       缩放矩形的一行像素
+ * @note        整数倍放大时每个源像素连续写k次,2倍时按32位一次写两个像素;
+ *              其他比例按最近邻逐像素取,源坐标用累加代替除法
+ * @param       blit : 映射
+ * @param       src  : 源像素(矩形的一整行,rect->w个)
+ * @param       rect : 源矩形
+ * @param       dst  : 输出缓存
+ * @retval      输出的像素数(与anim_blit_rect()得到的屏幕矩形宽度相同)
+ */
+uint16_t anim_blit_row(const anim_blit_t *blit, const uint16_t *src, const anim_rect_t *rect, uint16_t *dst)
+{
+    anim_rect_t out;
+    uint32_t *d32;
+    uint32_t pos;
+    uint32_t rem;
+    uint32_t s;
+    uint16_t i;
+    uint16_t k;
+
+    if (anim_blit_span(rect->x, rect->w, blit->src_w, blit->dst_w, blit->dst_x,
+                       blit->clip_x, blit->clip_x + blit->clip_w, &out.x, &out.w))
+    {
+        return 0;
+    }
+
+    pos = out.x - blit->dst_x;                              /* 第一个输出像素在缩放后帧中的列 */
+    s = pos * blit->src_w / blit->dst_w;
+    rem = pos * blit->src_w % blit->dst_w;
+    src += s - rect->x;
+
+    if (blit->dst_w % blit->src_w == 0 && rem == 0 && out.w % (blit->dst_w / blit->src_w) == 0)
+    {
+        k = blit->dst_w / blit->src_w;                      /* 整数倍,且从源像素边界开始 */
+
+        if (k == 2 && ((uintptr_t)dst & 3) == 0)
+        {
+            d32 = (uint32_t *)dst;
+
+            for (i = 0; i < out.w / 2; i++)
+            {
+                d32[i] = src[i] | ((uint32_t)src[i] << 16);
+            }
+        }
+        else
+        {
+            for (i = 0; i < out.w; i += k)
+            {
+                for (s = 0; s < k; s++)
+                {
+                    dst[i + s] = src[i / k];
+                }
+            }
+        }
+
+        return out.w;
+    }
+
+    for (i = 0; i < out.w; i++)                             /* 任意比例:累加源坐标 */
+    {
+        dst[i] = *src;
+        rem += blit->src_w;
+
+        while (rem >= blit->dst_w)
+        {
+            rem -= blit->dst_w;
+            src++;
+        }
+    }
+
+    return out.w;
+}
+
+/**
+ * @brief       两组像素按比例混合(交叉淡入淡出)
+ * @note        像素为面板字节序的RGB565:先换回RGB565,把绿色分量移到高16位,
+ *              红/绿/蓝三个分量在一个32位字中同时乘加,每像素只需一次乘法对
+ * @param       dst   : 新画面的像素,混合结果写回
+ * @param       from  : 旧画面的像素
+ * @param       n     : 像素数
+ * @param       alpha : 新画面的权重 0~ANIM_BLEND_MAX
+ * @retval      无
+ */
+void anim_blend(uint16_t *dst, const uint16_t *from, size_t n, uint8_t alpha)
+{
+    uint32_t a, b, x;
+    uint16_t c;
+    size_t i;
+
+    if (alpha >= ANIM_BLEND_MAX)
+    {
+        return;
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        c = (uint16_t)((dst[i] >> 8) | (dst[i] << 8));
+        a = (c | ((uint32_t)c << 16)) & 0x07E0F81F;
+        c = (uint16_t)((from[i] >> 8) | (from[i] << 8));
+        b = (c | ((uint32_t)c << 16)) & 0x07E0F81F;
+        x = ((a * alpha + b * (ANIM_BLEND_MAX - alpha)) >> 5) & 0x07E0F81F;
+        c = (uint16_t)(x | (x >> 16));
+        dst[i] = (uint16_t)((c >> 8) | (c << 8));
+    }
+}
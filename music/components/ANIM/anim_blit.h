@@ -0,0 +1,50 @@
+/**
+ ****************************************************************************************************
+ * @file        anim_blit.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       动画帧缩放/居中/混合 代码
+ *              把帧(及其脏矩形)按最近邻映射到屏幕上的任意窗口:原尺寸居中、整数倍放大居中、
+ *              等比缩放居中或拉伸铺满。素材可以按小尺寸制作(如120x120放大2倍铺满240x240),
+ *              存储空间和读取带宽降为1/4
+ *              映射关系: 目标像素X取源像素 floor(X * 源宽 / 目标宽),行同理,
+ *              因此源矩形[x, x+w)对应目标矩形[ceil(x * 目标宽 / 源宽), ceil((x+w) * 目标宽 / 源宽))
+ ****************************************************************************************************
+ */
+
+#ifndef __ANIM_BLIT_H
+#define __ANIM_BLIT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "anim.h"
+
+
+/* 缩放方式 */
+#define ANIM_BLIT_CENTER        0           /* 原尺寸居中(窗口较小时裁掉四周) */
+#define ANIM_BLIT_INTEGER       1           /* 按能放下的最大整数倍放大后居中(放不下时同原尺寸居中) */
+#define ANIM_BLIT_FIT           2           /* 等比缩放到刚好放下后居中 */
+#define ANIM_BLIT_STRETCH       3           /* 拉伸铺满窗口 */
+
+#define ANIM_BLEND_MAX          32          /* 混合权重满值(只显示新画面) */
+
+/* 帧到屏幕的映射 */
+typedef struct
+{
+    uint16_t src_w, src_h;                  /* 帧尺寸 */
+    int16_t dst_x, dst_y;                   /* 缩放后帧的左上角(屏幕坐标,居中裁剪时可为负) */
+    uint16_t dst_w, dst_h;                  /* 缩放后帧的尺寸 */
+    uint16_t clip_x, clip_y;                /* 窗口(超出部分裁掉) */
+    uint16_t clip_w, clip_h;
+    uint8_t scaled;                         /* 0,1:1只需平移;1,需要缩放 */
+} anim_blit_t;
+
+/* 函数声明 */
+void anim_blit_init(anim_blit_t *blit, uint16_t src_w, uint16_t src_h,
+                    uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t mode);  /* 计算帧到窗口的映射 */
+uint8_t anim_blit_rect(const anim_blit_t *blit, const anim_rect_t *src, anim_rect_t *dst);  /* 源矩形映射到屏幕 */
+uint16_t anim_blit_rows(const anim_blit_t *blit, uint16_t src_y);                  /* 源的一行对应屏幕的行数 */
+uint16_t anim_blit_row(const anim_blit_t *blit, const uint16_t *src, const anim_rect_t *rect, uint16_t *dst);   /* 缩放一行像素 */
+void anim_blend(uint16_t *dst, const uint16_t *from, size_t n, uint8_t alpha);     /* 两组像素按比例混合 */
+
+#endif
@@ -0,0 +1,404 @@
+/**
+ ****************************************************************************************************
+ * @file        anim_cache.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       动画包预读缓存 代码
+ ****************************************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "anim_stream.h"
+#include "anim_cache.h"
+
+
+#define ANIM_CACHE_FREE         0           /* 空闲 */
+#define ANIM_CACHE_LOADING      1           /* 正在读取 */
+#define ANIM_CACHE_READY        2           /* 已缓存 */
+#define ANIM_CACHE_MISSING      3           /* SD卡上没有该动画包(避免重复查找) */
+
+/* 缓存项 */
+typedef struct
+{
+    char name[ANIM_CACHE_NAME_SIZE];        /* 包名 */
+    uint8_t *data;                          /* 动画包数据 */
+    uint32_t size;                          /* 动画包长度 */
+    uint32_t used;                          /* 最近使用的时间(序号) */
+    uint8_t state;                          /* ANIM_CACHE_xxx */
+    uint8_t refs;                           /* 正在使用的次数,大于0时不会被淘汰 */
+} anim_cache_entry_t;
+
+static anim_cache_entry_t anim_cache[ANIM_CACHE_ENTRIES];
+static anim_cache_stats_t anim_cache_stats;
+static uint32_t anim_cache_clock = 0;           /* 使用序号,越大越近 */
+static SemaphoreHandle_t anim_cache_mutex = NULL;
+static QueueHandle_t anim_cache_queue = NULL;   /* 预读请求队列(缓存项) */
+
+/**
+ * @brief       查找缓存项(调用前需持有anim_cache_mutex)
+ * @param       name : 包名
+ * @retval      缓存项,NULL表示没有
+ */
+static anim_cache_entry_t *anim_cache_find(const char *name)
+{
+    uint8_t i;
+
+    for (i = 0; i < ANIM_CACHE_ENTRIES; i++)
+    {
+        if (anim_cache[i].state != ANIM_CACHE_FREE && strcmp(anim_cache[i].name, name) == 0)
+        {
+            return &anim_cache[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief       淘汰最久未使用的缓存项(调用前需持有anim_cache_mutex)
+ * @note        正在读取和正在使用的项不会被淘汰
+ * @param       keep : 不淘汰的项,NULL表示没有
+ * @retval      0,成功;1,没有可淘汰的项
+ */
+static uint8_t anim_cache_evict(const anim_cache_entry_t *keep)
+{
+    anim_cache_entry_t *victim = NULL;
+    uint8_t i;
+
+    for (i = 0; i < ANIM_CACHE_ENTRIES; i++)
+    {
+        if (&anim_cache[i] != keep && anim_cache[i].refs == 0 &&
+            (anim_cache[i].state == ANIM_CACHE_READY || anim_cache[i].state == ANIM_CACHE_MISSING) &&
+            (victim == NULL || (int32_t)(anim_cache[i].used - victim->used) < 0))
+        {
+            victim = &anim_cache[i];
+        }
+    }
+
+    if (victim == NULL)
+    {
+        return 1;
+    }
+
+    if (victim->state == ANIM_CACHE_READY)
+    {
+        free(victim->data);
+        anim_cache_stats.used -= victim->size;
+        anim_cache_stats.evictions++;
+    }
+
+    victim->data = NULL;
+    victim->size = 0;
+    victim->state = ANIM_CACHE_FREE;
+
+    return 0;
+}
+
+/**
+ * @brief       申请缓存内存:有PSRAM时只用PSRAM,内部RAM最多占用ANIM_CACHE_INTERNAL字节
+ * @param       size : 字节数
+ * @retval      内存地址,NULL表示失败
+ */
+static uint8_t *anim_cache_alloc(uint32_t size)
+{
+#if CONFIG_SPIRAM
+    return heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+#else
+    return heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+#endif
+}
+
+/**
+ * @brief       读入一个动画包
+ * @note        先在预算内预留空间(不够时淘汰旧包),再在锁外读取,读取期间缓存仍可使用
+ * @param       e : 缓存项(状态为ANIM_CACHE_LOADING)
+ * @retval      无
+ */
+static void anim_cache_load(anim_cache_entry_t *e)
+{
+    char path[48];
+    anim_pack_t pack;
+    FIL *file;
+    uint8_t *data = NULL;
+    uint32_t size;
+    uint32_t reserved = 0;
+    uint8_t missing = 1;
+    UINT br = 0;
+
+    snprintf(path, sizeof(path), "%s/%s.anm", ANIM_DIR, e->name);
+    file = (FIL *)malloc(sizeof(FIL));
+
+    if (file != NULL && f_open(file, (const TCHAR *)path, FA_READ) == FR_OK)
+    {
+        missing = 0;
+        size = f_size(file);
+
+        xSemaphoreTake(anim_cache_mutex, portMAX_DELAY);
+
+        while (size <= ANIM_CACHE_BUDGET && anim_cache_stats.used + size > ANIM_CACHE_BUDGET && anim_cache_evict(e) == 0)
+        {
+        }
+
+        if (size > 0 && anim_cache_stats.used + size <= ANIM_CACHE_BUDGET)
+        {
+            anim_cache_stats.used += size;
+            reserved = size;
+        }
+
+        xSemaphoreGive(anim_cache_mutex);
+
+        if (reserved)
+        {
+            data = anim_cache_alloc(reserved);
+
+            if (data != NULL && (f_read(file, data, reserved, &br) != FR_OK || br != reserved ||
+                                 anim_pack_open(&pack, data, reserved) != 0))
+            {
+                free(data);
+                data = NULL;
+            }
+        }
+
+        f_close(file);
+    }
+
+    free(file);
+
+    xSemaphoreTake(anim_cache_mutex, portMAX_DELAY);
+
+    if (data != NULL)
+    {
+        e->data = data;
+        e->size = reserved;
+        e->state = ANIM_CACHE_READY;
+        anim_cache_stats.loads++;
+    }
+    else
+    {
+        anim_cache_stats.used -= reserved;                      /* 放不下或读取失败时以后再试 */
+        e->state = missing ? ANIM_CACHE_MISSING : ANIM_CACHE_FREE;
+    }
+
+    xSemaphoreGive(anim_cache_mutex);
+}
+
+/**
+ * @brief       预读任务:依次读入请求的动画包
+ * @param       pvParameters : 传入参数(未用到)
+ * @retval      无
+ */
+static void anim_cache_task(void *pvParameters)
+{
+    anim_cache_entry_t *e;
+
+    pvParameters = pvParameters;
+
+    while (1)
+    {
+        if (xQueueReceive(anim_cache_queue, &e, portMAX_DELAY) == pdTRUE)
+        {
+            anim_cache_load(e);
+        }
+    }
+}
+
+/**
+ * @brief       初始化缓存,创建预读任务
+ * @note        只在第一次调用时初始化
+ * @param       无
+ * @retval      0,成功;1,失败
+ */
+uint8_t anim_cache_init(void)
+{
+    if (anim_cache_queue != NULL)
+    {
+        return 0;
+    }
+
+    anim_cache_mutex = xSemaphoreCreateMutex();
+    anim_cache_queue = xQueueCreate(ANIM_CACHE_QUEUE_LEN, sizeof(anim_cache_entry_t *));
+
+    if (anim_cache_mutex == NULL || anim_cache_queue == NULL ||
+        xTaskCreate(anim_cache_task, "anim_cache", ANIM_CACHE_STK_SIZE, NULL, ANIM_CACHE_PRIO, NULL) != pdPASS)
+    {
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief       请求后台预读动画包
+ * @note        已缓存、正在读取或已知不存在时直接返回,不会重复读取
+ * @param       name : 包名,如"sad_loop",对应文件 0:/ANIM/sad_loop.anm
+ * @retval      0,已缓存或已排入预读队列
+ *              1,缓存未初始化或名字过长
+ *              2,缓存项已全部在使用或队列已满
+ */
+uint8_t anim_cache_prefetch(const char *name)
+{
+    anim_cache_entry_t *e;
+    uint8_t res = 0;
+    uint8_t i;
+
+    if (anim_cache_queue == NULL || name == NULL || strlen(name) >= ANIM_CACHE_NAME_SIZE)
+    {
+        return 1;
+    }
+
+    xSemaphoreTake(anim_cache_mutex, portMAX_DELAY);
+    e = anim_cache_find(name);
+
+    if (e == NULL)
+    {
+        for (i = 0; i < ANIM_CACHE_ENTRIES && anim_cache[i].state != ANIM_CACHE_FREE; i++)
+        {
+        }
+
+        if (i < ANIM_CACHE_ENTRIES || anim_cache_evict(NULL) == 0)
+        {
+            for (i = 0; anim_cache[i].state != ANIM_CACHE_FREE; i++)
+            {
+            }
+
+            e = &anim_cache[i];
+            strcpy(e->name, name);
+            e->refs = 0;
+            e->state = ANIM_CACHE_LOADING;
+
+            if (xQueueSend(anim_cache_queue, &e, 0) != pdTRUE)
+            {
+                e->state = ANIM_CACHE_FREE;
+                e = NULL;
+            }
+        }
+
+        res = (e == NULL) ? 2 : 0;
+    }
+
+    if (e != NULL)
+    {
+        e->used = ++anim_cache_clock;                           /* 即将使用,不要被随后的预读淘汰 */
+    }
+
+    xSemaphoreGive(anim_cache_mutex);
+
+    return res;
+}
+
+/**
+ * @brief       取得已缓存的动画包
+ * @note        不等待读取,未缓存或仍在读取时直接返回NULL;用完后调用anim_cache_put()
+ * @param       name : 包名
+ * @param       size : 动画包长度
+ * @retval      动画包数据,NULL表示未缓存
+ */
+const uint8_t *anim_cache_get(const char *name, uint32_t *size)
+{
+    anim_cache_entry_t *e;
+    const uint8_t *data = NULL;
+
+    if (anim_cache_mutex == NULL || name == NULL)
+    {
+        return NULL;
+    }
+
+    xSemaphoreTake(anim_cache_mutex, portMAX_DELAY);
+    e = anim_cache_find(name);
+
+    if (e != NULL && e->state == ANIM_CACHE_READY)
+    {
+        e->refs++;
+        e->used = ++anim_cache_clock;
+        data = e->data;
+        *size = e->size;
+        anim_cache_stats.hits++;
+    }
+    else
+    {
+        anim_cache_stats.misses++;
+    }
+
+    xSemaphoreGive(anim_cache_mutex);
+
+    return data;
+}
+
+/**
+ * @brief       用完动画包,之后可以被淘汰
+ * @param       data : anim_cache_get()返回的数据
+ * @retval      无
+ */
+void anim_cache_put(const uint8_t *data)
+{
+    uint8_t i;
+
+    if (data == NULL)
+    {
+        return;
+    }
+
+    xSemaphoreTake(anim_cache_mutex, portMAX_DELAY);
+
+    for (i = 0; i < ANIM_CACHE_ENTRIES; i++)
+    {
+        if (anim_cache[i].state == ANIM_CACHE_READY && anim_cache[i].data == data && anim_cache[i].refs > 0)
+        {
+            anim_cache[i].refs--;
+            break;
+        }
+    }
+
+    xSemaphoreGive(anim_cache_mutex);
+}
+
+/**
+ * @brief       查询SD卡上是否没有该动画包
+ * @note        只有预读过的包才知道结果;返回1时不必再打开SD卡上的文件
+ * @param       name : 包名
+ * @retval      0,在SD卡上或尚未查找过;1,SD卡上没有
+ */
+uint8_t anim_cache_missing(const char *name)
+{
+    anim_cache_entry_t *e;
+    uint8_t missing = 0;
+
+    if (anim_cache_mutex == NULL || name == NULL)
+    {
+        return 0;
+    }
+
+    xSemaphoreTake(anim_cache_mutex, portMAX_DELAY);
+    e = anim_cache_find(name);
+
+    if (e != NULL && e->state == ANIM_CACHE_MISSING)
+    {
+        e->used = ++anim_cache_clock;
+        missing = 1;
+    }
+
+    xSemaphoreGive(anim_cache_mutex);
+
+    return missing;
+}
+
+/**
+ * @brief       获取缓存统计
+ * @param       stats : 统计数据
+ * @retval      无
+ */
+void anim_cache_get_stats(anim_cache_stats_t *stats)
+{
+    if (anim_cache_mutex == NULL)
+    {
+        memset(stats, 0, sizeof(anim_cache_stats_t));
+        return;
+    }
+
+    xSemaphoreTake(anim_cache_mutex, portMAX_DELAY);
+    *stats = anim_cache_stats;
+    xSemaphoreGive(anim_cache_mutex);
+}
@@ -0,0 +1,62 @@
+/**
+ ****************************************************************************************************
+ * @file        anim_cache.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       动画包预读缓存 代码
+ *              播放当前序列时,由后台任务把接下来要播放的序列(SD卡ANIM目录下的整个动画包)读入内存,
+ *              序列开始时直接从内存解码,首帧不必等待SD卡读取
+ *              缓存总量不超过ANIM_CACHE_BUDGET字节,超出时淘汰最久未使用且未在播放的动画包;
+ *              开启PSRAM(CONFIG_SPIRAM)时缓存放在PSRAM中;没有PSRAM时预算为0,不缓存动画包(内部RAM留给
+ *              音频和LCD),只记录SD卡上没有的动画包,播放时不必再到SD卡上查找(SD卡只在启动时挂载一次)
+ ****************************************************************************************************
+ */
+
+#ifndef __ANIM_CACHE_H
+#define __ANIM_CACHE_H
+
+#include "sdkconfig.h"
+#include "anim.h"
+
+
+/* 缓存预算(字节),可在编译选项中指定 */
+#ifndef ANIM_CACHE_BUDGET
+#if CONFIG_SPIRAM
+#define ANIM_CACHE_BUDGET       (1024 * 1024)
+#else
+#define ANIM_CACHE_BUDGET       0
+#endif
+#endif
+
+/* 缓存最多占用的内部RAM(字节):有PSRAM时只放在PSRAM中 */
+#if CONFIG_SPIRAM
+#define ANIM_CACHE_INTERNAL     0
+#else
+#define ANIM_CACHE_INTERNAL     ANIM_CACHE_BUDGET
+#endif
+
+#define ANIM_CACHE_ENTRIES      8           /* 最多缓存的动画包数(含记录为不存在的包) */
+#define ANIM_CACHE_NAME_SIZE    24          /* 包名最大长度(含结束符) */
+#define ANIM_CACHE_QUEUE_LEN    8           /* 预读请求队列长度 */
+#define ANIM_CACHE_PRIO         2           /* 预读任务优先级(低于动画任务,不影响当前序列的读取) */
+#define ANIM_CACHE_STK_SIZE     3 * 1024    /* 预读任务堆栈大小 */
+
+/* 缓存统计 */
+typedef struct
+{
+    uint32_t hits;                          /* 命中次数 */
+    uint32_t misses;                        /* 未命中次数 */
+    uint32_t loads;                         /* 读入的动画包数 */
+    uint32_t evictions;                     /* 淘汰的动画包数 */
+    uint32_t used;                          /* 当前占用的字节数 */
+} anim_cache_stats_t;
+
+/* 函数声明 */
+uint8_t anim_cache_init(void);                                          /* 初始化缓存,创建预读任务 */
+uint8_t anim_cache_prefetch(const char *name);                          /* 请求后台预读动画包 */
+const uint8_t *anim_cache_get(const char *name, uint32_t *size);        /* 取得已缓存的动画包 */
+void anim_cache_put(const uint8_t *data);                               /* 用完动画包 */
+uint8_t anim_cache_missing(const char *name);                           /* 查询SD卡上是否没有该动画包 */
+void anim_cache_get_stats(anim_cache_stats_t *stats);                   /* 获取缓存统计 */
+
+#endif
@@ -0,0 +1,114 @@
+/**
+ ****************************************************************************************************
+ * @file        anim_flash.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       Flash动画分区 代码
+ ****************************************************************************************************
+ */
+
+#include "esp_log.h"
+#include "anim_flash.h"
+
+
+static const char *TAG = "anim_flash";
+
+static const uint8_t *anim_bundle = NULL;       /* 分区映射地址 */
+static uint32_t anim_bundle_size = 0;           /* 映射长度 */
+static uint8_t anim_flash_res = 0xFF;           /* 映射结果,0xFF表示尚未映射 */
+static esp_partition_mmap_handle_t anim_mmap_handle;
+
+/**
+ * @brief       读取小端32位数据
+ * @param       p : 数据地址
+ * @retval      读出的值
+ */
+static uint32_t anim_flash_rd32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief       映射动画分区
+ * @note        只映射镜像实际使用的长度
+ * @param       无
+ * @retval      见anim_flash_init()
+ */
+static uint8_t anim_flash_map(void)
+{
+    const esp_partition_t *part;
+    uint8_t header[ANIM_BUNDLE_HEADER_SIZE];
+    const void *ptr;
+    uint32_t total;
+    uint16_t count;
+
+    part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, ANIM_PARTITION_NAME);
+
+    if (part == NULL)
+    {
+        return 1;
+    }
+
+    if (esp_partition_read(part, 0, header, sizeof(header)) != ESP_OK)
+    {
+        return 2;
+    }
+
+    count = header[6] | (header[7] << 8);
+    total = anim_flash_rd32(header + 8);
+
+    if (anim_flash_rd32(header) != ANIM_BUNDLE_MAGIC || header[4] != ANIM_BUNDLE_VERSION ||
+        total > part->size || total < ANIM_BUNDLE_HEADER_SIZE + (uint32_t)count * ANIM_BUNDLE_ENTRY_SIZE)
+    {
+        ESP_LOGW(TAG, "no animation bundle in partition \"%s\"", ANIM_PARTITION_NAME);
+        return 2;
+    }
+
+    if (esp_partition_mmap(part, 0, total, ESP_PARTITION_MMAP_DATA, &ptr, &anim_mmap_handle) != ESP_OK)
+    {
+        ESP_LOGE(TAG, "mmap failed");
+        return 3;
+    }
+
+    anim_bundle = (const uint8_t *)ptr;
+    anim_bundle_size = total;
+    ESP_LOGI(TAG, "%d packs, %ld bytes mapped", count, (long)total);
+
+    return 0;
+}
+
+/**
+ * @brief       映射动画分区
+ * @note        只在第一次调用时映射,之后直接返回第一次的结果
+ * @param       无
+ * @retval      0,成功
+ *              1,没有动画分区
+ *              2,分区内容不是有效的镜像(未烧录)
+ *              3,映射失败
+ */
+uint8_t anim_flash_init(void)
+{
+    if (anim_flash_res == 0xFF)
+    {
+        anim_flash_res = anim_flash_map();
+    }
+
+    return anim_flash_res;
+}
+
+/**
+ * @brief       按名字查找动画包
+ * @param       name : 包名,如"sad_loop"
+ * @param       data : 动画包地址(指向Flash映射区)
+ * @param       size : 动画包长度
+ * @retval      0,找到;1,未找到(或动画分区不可用)
+ */
+uint8_t anim_flash_find(const char *name, const uint8_t **data, uint32_t *size)
+{
+    if (anim_flash_init() != 0)
+    {
+        return 1;
+    }
+
+    return anim_bundle_find(anim_bundle, anim_bundle_size, name, data, size) == 0 ? 0 : 1;
+}
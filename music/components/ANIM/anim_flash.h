@@ -0,0 +1,25 @@
+/**
+ ****************************************************************************************************
+ * @file        anim_flash.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       Flash动画分区 代码
+ *              动画包由 tools/anim_bundle.py 合并为动画集(格式见anim.h)后烧录到 anim 数据分区,
+ *              启动后整个分区通过esp_partition_mmap映射到地址空间,解码器直接读取Flash,不占用堆
+ ****************************************************************************************************
+ */
+
+#ifndef __ANIM_FLASH_H
+#define __ANIM_FLASH_H
+
+#include "esp_partition.h"
+#include "anim.h"
+
+
+#define ANIM_PARTITION_NAME     "anim"      /* 动画分区名(见partitions.csv) */
+
+/* 函数声明 */
+uint8_t anim_flash_init(void);                                                  /* 映射动画分区 */
+uint8_t anim_flash_find(const char *name, const uint8_t **data, uint32_t *size);   /* 按名字查找动画包 */
+
+#endif
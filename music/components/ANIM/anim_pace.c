@@ -0,0 +1,178 @@
+/**
+ ****************************************************************************************************
+ * @file        anim_pace.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       动画帧节奏控制 代码
+ ****************************************************************************************************
+ */
+
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "anim_pace.h"
+
+
+/**
+ * @brief       读取排期所用的时钟
+ * @param       pace : 帧节奏控制
+ * @retval      当前时刻(us)
+ */
+static int64_t anim_pace_now(anim_pace_t *pace)
+{
+    return pace->clock ? pace->clock() : esp_timer_get_time();
+}
+
+/**
+ * @brief       以指定时钟从当前时刻开始排期,并清零统计
+ * @note        时钟须单调不减,暂停时可以停走(如按音频实际播放的采样数计时),
+ *              时钟停走期间anim_pace_wait()一直等待,画面随之暂停
+ * @param       pace  : 帧节奏控制
+ * @param       clock : 时钟,NULL表示使用系统时间(esp_timer)
+ * @retval      无
+ */
+void anim_pace_start_clock(anim_pace_t *pace, anim_clock_t clock)
+{
+    memset(pace, 0, sizeof(anim_pace_t));
+    pace->clock = clock;
+    pace->deadline = anim_pace_now(pace);
+}
+
+/**
+ * @brief       从当前时刻开始排期,并清零统计
+ * @param       pace : 帧节奏控制
+ * @retval      无
+ */
+void anim_pace_start(anim_pace_t *pace)
+{
+    anim_pace_start_clock(pace, NULL);
+}
+
+/**
+ * @brief       绘制前判断本帧是否跳过
+ * @note        差分帧依赖上一帧的画面,只有下一帧是关键帧时本帧才能跳过(skippable由调用者判断)
+ *              跳过时本帧的显示时段计入排期,调用者直接处理下一帧
+ * @param       pace      : 帧节奏控制
+ * @param       duration  : 本帧显示时长(ms)
+ * @param       skippable : 1,本帧可以跳过;0,必须绘制
+ * @retval      1,跳过本帧;0,绘制本帧
+ */
+uint8_t anim_pace_skip(anim_pace_t *pace, uint16_t duration, uint8_t skippable)
+{
+    int64_t lag = anim_pace_now(pace) - pace->deadline;
+
+    if (lag > ANIM_PACE_RESYNC_MS * 1000LL)                 /* 落后太多,追赶没有意义 */
+    {
+        pace->deadline += lag;
+        pace->resync++;
+        return 0;
+    }
+
+    if (skippable && lag >= duration * 1000LL)              /* 本帧的显示时段已经整个错过 */
+    {
+        pace->deadline += duration * 1000LL;
+        pace->dropped++;
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief       计算到当前排期时刻还需等待的系统节拍数
+ * @note        按系统节拍四舍五入,但排期时刻由上一时刻推算,误差不会累积
+ *              排期时刻已过时返回0,并记录最大落后时间
+ * @param       pace : 帧节奏控制
+ * @retval      需等待的节拍数
+ */
+uint32_t anim_pace_ticks(anim_pace_t *pace)
+{
+    int64_t remain = pace->deadline - anim_pace_now(pace);
+    int64_t tick_us = portTICK_PERIOD_MS * 1000LL;
+
+    if (remain < 0)
+    {
+        if (-remain > pace->max_lag_us)
+        {
+            pace->max_lag_us = (int32_t)(-remain);
+        }
+
+        return 0;
+    }
+
+    return (uint32_t)((remain + tick_us / 2) / tick_us);
+}
+
+/**
+ * @brief       本帧已绘制,把排期推进到下一帧的显示时刻
+ * @note        不等待,由调用者按返回的节拍数等待(如阻塞在消息队列上,等待期间仍可处理命令)
+ * @param       pace     : 帧节奏控制
+ * @param       duration : 本帧显示时长(ms)
+ * @retval      需等待的节拍数
+ */
+uint32_t anim_pace_advance(anim_pace_t *pace, uint16_t duration)
+{
+    pace->frames++;
+    pace->deadline += duration * 1000LL;
+
+    if (anim_pace_now(pace) > pace->deadline)              /* 绘制完成时已过了本帧的显示时段 */
+    {
+        pace->late++;
+    }
+
+    return anim_pace_ticks(pace);
+}
+
+/**
+ * @brief       在排期中插入一段停顿(保持当前画面),不等待
+ * @param       pace : 帧节奏控制
+ * @param       ms   : 停顿时长(ms)
+ * @retval      需等待的节拍数
+ */
+uint32_t anim_pace_hold(anim_pace_t *pace, uint32_t ms)
+{
+    pace->deadline += ms * 1000LL;
+
+    return anim_pace_ticks(pace);
+}
+
+/**
+ * @brief       等待到当前排期时刻
+ * @note        排期时钟可能比系统时间走得慢(如音频卡顿),醒来后重新计算,直到时钟到达排期时刻
+ * @param       pace : 帧节奏控制
+ * @retval      无
+ */
+static void anim_pace_sleep(anim_pace_t *pace)
+{
+    uint32_t ticks;
+
+    while ((ticks = anim_pace_ticks(pace)) > 0)
+    {
+        vTaskDelay(ticks);
+    }
+}
+
+/**
+ * @brief       本帧已绘制,等待到下一帧的显示时刻
+ * @param       pace     : 帧节奏控制
+ * @param       duration : 本帧显示时长(ms)
+ * @retval      无
+ */
+void anim_pace_wait(anim_pace_t *pace, uint16_t duration)
+{
+    anim_pace_advance(pace, duration);
+    anim_pace_sleep(pace);
+}
+
+/**
+ * @brief       在排期中插入一段停顿(保持当前画面)
+ * @param       pace : 帧节奏控制
+ * @param       ms   : 停顿时长(ms)
+ * @retval      无
+ */
+void anim_pace_pause(anim_pace_t *pace, uint32_t ms)
+{
+    anim_pace_hold(pace, ms);
+    anim_pace_sleep(pace);
+}
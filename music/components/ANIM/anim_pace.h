@@ -0,0 +1,46 @@
+/**
+ ****************************************************************************************************
+ * @file        anim_pace.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       动画帧节奏控制 代码
+ *              按绝对时刻排期:每帧的显示时刻 = 上一帧的显示时刻 + 上一帧时长(取自帧信息表),
+ *              绘制耗时和系统节拍取整都不会累积;落后时可跳过允许跳过的帧,并统计超时/丢帧
+ *              排期默认使用系统时间,也可以换成其他时钟(如音频播放进度),使动画与之同步
+ ****************************************************************************************************
+ */
+
+#ifndef __ANIM_PACE_H
+#define __ANIM_PACE_H
+
+#include <stdint.h>
+
+
+#define ANIM_PACE_RESYNC_MS     500         /* 落后超过该时间(如LCD被长时间占用)不再追赶,从当前时刻重新排期 */
+
+/* 排期时钟,返回当前时刻(us) */
+typedef int64_t (*anim_clock_t)(void);
+
+/* 帧节奏控制 */
+typedef struct
+{
+    anim_clock_t clock;                     /* 排期时钟,NULL表示系统时间 */
+    int64_t deadline;                       /* 当前帧的显示时刻(us) */
+    uint32_t frames;                        /* 已显示帧数 */
+    uint32_t late;                          /* 超时帧数:绘制完成时本帧的显示时段已过 */
+    uint32_t dropped;                       /* 丢弃帧数:轮到时显示时段已过,未绘制直接跳过 */
+    uint32_t resync;                        /* 重新排期次数 */
+    int32_t max_lag_us;                     /* 最大落后时间(us) */
+} anim_pace_t;
+
+/* 函数声明 */
+void anim_pace_start(anim_pace_t *pace);                                        /* 从当前时刻开始排期,清零统计 */
+void anim_pace_start_clock(anim_pace_t *pace, anim_clock_t clock);              /* 以指定时钟开始排期 */
+uint8_t anim_pace_skip(anim_pace_t *pace, uint16_t duration, uint8_t skippable);   /* 判断本帧是否跳过 */
+void anim_pace_wait(anim_pace_t *pace, uint16_t duration);                      /* 本帧已绘制,等待下一帧的显示时刻 */
+void anim_pace_pause(anim_pace_t *pace, uint32_t ms);                           /* 在排期中插入停顿 */
+uint32_t anim_pace_advance(anim_pace_t *pace, uint16_t duration);              /* 本帧已绘制,推进排期,返回需等待的节拍数 */
+uint32_t anim_pace_hold(anim_pace_t *pace, uint32_t ms);                        /* 在排期中插入停顿,返回需等待的节拍数 */
+uint32_t anim_pace_ticks(anim_pace_t *pace);                                    /* 到当前排期时刻还需等待的节拍数 */
+
+#endif
@@ -0,0 +1,279 @@
+/**
+ ****************************************************************************************************
+ * @file        anim_stream.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       SD卡动画包流式读取 代码
+ ****************************************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "anim_stream.h"
+
+
+/* 预读请求 */
+typedef struct
+{
+    anim_stream_t *stream;
+    uint8_t slot;
+    uint16_t index;
+} anim_load_req_t;
+
+static QueueHandle_t anim_load_queue = NULL;    /* 预读请求队列 */
+static TaskHandle_t anim_loader_handle = NULL;  /* 读取任务句柄 */
+
+/**
+ * @brief       把一帧读入指定缓存
+ * @param       s     : 动画包流
+ * @param       slot  : 缓存编号
+ * @param       index : 帧序号
+ * @retval      0,成功;1,失败
+ */
+static uint8_t anim_stream_load(anim_stream_t *s, uint8_t slot, uint16_t index)
+{
+    uint32_t offset;
+    uint32_t size;
+    UINT br = 0;
+
+    s->slot_index[slot] = -1;
+
+    if (anim_frame_info(&s->pack, index, &offset, &size) != 0 || size > s->buf_size)
+    {
+        return 1;
+    }
+
+    if (f_lseek(s->file, offset) != FR_OK || f_read(s->file, s->buf[slot], size, &br) != FR_OK || br != size)
+    {
+        return 1;
+    }
+
+    s->slot_size[slot] = size;
+    s->slot_index[slot] = index;
+
+    return 0;
+}
+
+/**
+ * @brief       读取任务:处理预读请求,读完后通知请求方
+ * @param       pvParameters : 传入参数(未用到)
+ * @retval      无
+ */
+static void anim_loader_task(void *pvParameters)
+{
+    anim_load_req_t req;
+
+    pvParameters = pvParameters;
+
+    while (1)
+    {
+        if (xQueueReceive(anim_load_queue, &req, portMAX_DELAY) == pdTRUE)
+        {
+            anim_stream_load(req.stream, req.slot, req.index);
+            xSemaphoreGive(req.stream->done);
+        }
+    }
+}
+
+/**
+ * @brief       等待未完成的预读
+ * @param       s : 动画包流
+ * @retval      无
+ */
+static void anim_stream_wait(anim_stream_t *s)
+{
+    if (s->pending)
+    {
+        xSemaphoreTake(s->done, portMAX_DELAY);
+        s->pending = 0;
+    }
+}
+
+/**
+ * @brief       打开ANIM目录下的动画包
+ * @param       s    : 动画包流
+ * @param       name : 动画名,如"sad_in",对应文件 0:/ANIM/sad_in.anm
+ * @retval      0,成功
+ *              1,文件不存在或打开失败
+ *              2,不是有效的动画包
+ *              3,内存申请失败
+ */
+uint8_t anim_stream_open(anim_stream_t *s, const char *name)
+{
+    char path[48];
+    uint8_t header[ANIM_HEADER_SIZE];
+    uint32_t head_size;
+    uint32_t offset;
+    uint32_t size;
+    uint16_t i;
+    UINT br = 0;
+    uint8_t res = 0;
+
+    memset(s, 0, sizeof(anim_stream_t));
+    s->slot_index[0] = -1;
+    s->slot_index[1] = -1;
+
+    if (anim_load_queue == NULL)                                /* 首次使用时创建读取任务 */
+    {
+        anim_load_queue = xQueueCreate(1, sizeof(anim_load_req_t));
+
+        if (anim_load_queue == NULL)
+        {
+            return 3;
+        }
+
+        if (xTaskCreate(anim_loader_task, "anim_loader", ANIM_LOADER_STK_SIZE, NULL, ANIM_LOADER_PRIO, &anim_loader_handle) != pdPASS)
+        {
+            vQueueDelete(anim_load_queue);                      /* 没有读取任务时预读会一直等不到完成,下次再试 */
+            anim_load_queue = NULL;
+            return 3;
+        }
+    }
+
+    snprintf(path, sizeof(path), "%s/%s.anm", ANIM_DIR, name);
+    s->file = (FIL *)malloc(sizeof(FIL));
+
+    if (s->file == NULL)
+    {
+        return 3;
+    }
+
+    if (f_open(s->file, (const TCHAR *)path, FA_READ) != FR_OK)
+    {
+        free(s->file);
+        s->file = NULL;
+        return 1;
+    }
+
+    if (f_read(s->file, header, ANIM_HEADER_SIZE, &br) != FR_OK || br != ANIM_HEADER_SIZE)
+    {
+        res = 2;
+    }
+    else if ((head_size = anim_head_size(header)) == 0)
+    {
+        res = 2;
+    }
+    else if ((s->head = malloc(head_size)) == NULL)
+    {
+        res = 3;
+    }
+    else
+    {
+        s->head_size = head_size;
+        memcpy(s->head, header, ANIM_HEADER_SIZE);              /* 读出其余索引信息 */
+
+        if (f_read(s->file, s->head + ANIM_HEADER_SIZE, head_size - ANIM_HEADER_SIZE, &br) != FR_OK ||
+            br != head_size - ANIM_HEADER_SIZE ||
+            anim_pack_open_head(&s->pack, s->head, head_size, f_size(s->file)) != 0)
+        {
+            res = 2;
+        }
+    }
+
+    if (res == 0)
+    {
+        for (i = 0; anim_frame_info(&s->pack, i, &offset, &size) == 0; i++)    /* 缓存按最大帧分配 */
+        {
+            if (size > s->buf_size)
+            {
+                s->buf_size = size;
+            }
+        }
+
+        s->buf[0] = malloc(s->buf_size);
+        s->buf[1] = malloc(s->buf_size);
+        s->done = xSemaphoreCreateBinary();
+
+        if (s->buf[0] == NULL || s->buf[1] == NULL || s->done == NULL)
+        {
+            res = 3;
+        }
+    }
+
+    if (res != 0)
+    {
+        anim_stream_close(s);
+    }
+
+    return res;
+}
+
+/**
+ * @brief       取得一帧数据,并在后台预读下一帧
+ * @note        返回的数据在下一次调用anim_stream_frame()或anim_stream_close()之前有效
+ * @param       s     : 动画包流
+ * @param       index : 需要的帧序号
+ * @param       next  : 接下来要播放的帧序号,ANIM_STREAM_NONE表示不预读
+ * @param       size  : 帧数据长度
+ * @retval      帧数据,NULL表示读取失败
+ */
+const uint8_t *anim_stream_frame(anim_stream_t *s, uint16_t index, uint16_t next, uint32_t *size)
+{
+    anim_load_req_t req;
+    uint8_t slot;
+
+    anim_stream_wait(s);                                        /* 上一次的预读必须先完成 */
+
+    if (s->slot_index[0] == index)
+    {
+        slot = 0;
+    }
+    else if (s->slot_index[1] == index)
+    {
+        slot = 1;
+    }
+    else                                                        /* 未命中预读,直接读取 */
+    {
+        slot = 0;
+
+        if (anim_stream_load(s, slot, index) != 0)
+        {
+            return NULL;
+        }
+    }
+
+    if (next != ANIM_STREAM_NONE && s->slot_index[slot ^ 1] != next)
+    {
+        req.stream = s;
+        req.slot = slot ^ 1;
+        req.index = next;
+        s->slot_index[slot ^ 1] = -1;
+        s->pending = 1;
+        xQueueSend(anim_load_queue, &req, portMAX_DELAY);
+    }
+
+    *size = s->slot_size[slot];
+
+    return s->buf[slot];
+}
+
+/**
+ * @brief       关闭动画包,释放内存
+ * @param       s : 动画包流
+ * @retval      无
+ */
+void anim_stream_close(anim_stream_t *s)
+{
+    anim_stream_wait(s);
+
+    if (s->file)
+    {
+        f_close(s->file);
+        free(s->file);
+        s->file = NULL;
+    }
+
+    if (s->done)
+    {
+        vSemaphoreDelete(s->done);
+        s->done = NULL;
+    }
+
+    free(s->buf[0]);
+    free(s->buf[1]);
+    free(s->head);
+    s->buf[0] = NULL;
+    s->buf[1] = NULL;
+    s->head = NULL;
+}
@@ -0,0 +1,49 @@
+/**
+ ****************************************************************************************************
+ * @file        anim_stream.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       SD卡动画包流式读取 代码
+ *              动画包(.anm)存放在SD卡ANIM目录下,只把包头/索引表/调色板常驻内存,
+ *              帧数据按需读取到双缓存中:播放当前帧的同时,由读取任务预读下一帧
+ ****************************************************************************************************
+ */
+
+#ifndef __ANIM_STREAM_H
+#define __ANIM_STREAM_H
+
+#include "ff.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "anim.h"
+
+
+#define ANIM_DIR                "0:/ANIM"   /* 动画包目录 */
+#define ANIM_STREAM_NONE        0xFFFF      /* 不预读 */
+
+#define ANIM_LOADER_PRIO        3           /* 读取任务优先级(与动画任务相同,低于音频任务) */
+#define ANIM_LOADER_STK_SIZE    3 * 1024    /* 读取任务堆栈大小 */
+
+/* 动画包流 */
+typedef struct
+{
+    FIL *file;                              /* 动画包文件 */
+    anim_pack_t pack;                       /* 包描述,pack.base只包含索引信息 */
+    uint8_t *head;                          /* 包头+帧索引表+调色板 */
+    uint32_t head_size;                     /* 包头部分的大小 */
+    uint8_t *buf[2];                        /* 帧数据双缓存 */
+    uint32_t buf_size;                      /* 单个缓存大小(最大帧长度) */
+    uint32_t slot_size[2];                  /* 缓存中帧数据的长度 */
+    int32_t slot_index[2];                  /* 缓存中的帧序号,-1表示无效 */
+    volatile uint8_t pending;               /* 有未完成的预读请求 */
+    SemaphoreHandle_t done;                 /* 预读完成信号 */
+} anim_stream_t;
+
+/* 函数声明 */
+uint8_t anim_stream_open(anim_stream_t *s, const char *name);                                  /* 打开ANIM目录下的动画包 */
+const uint8_t *anim_stream_frame(anim_stream_t *s, uint16_t index, uint16_t next, uint32_t *size);  /* 取得一帧数据并预读下一帧 */
+void anim_stream_close(anim_stream_t *s);                                                       /* 关闭动画包 */
+
+#endif
@@ -29,9 +29,35 @@
 #define SPI_LCD_TYPE    1           /* SPI接口屏幕类型（1：2.4寸SPILCD  0：1.3寸SPILCD） */  
 
 spi_device_handle_t MY_LCD_Handle;
-uint8_t lcd_buf[LCD_TOTAL_BUF_SIZE];
+uint8_t *lcd_buf = NULL;                                        /* 行缓存(LCD_BUF_SIZE字节,可DMA):填充图案/文字展开/帧缓存发送共用 */
 lcd_obj_t lcd_self;
 
+static spi_transaction_t lcd_trans[LCD_QUEUE_SIZE];            /* 排队发送的传输描述,按提交顺序环形使用 */
+static uint8_t lcd_trans_next = 0;                              /* 下一个可用的传输描述 */
+static uint8_t lcd_async_pending = 0;                           /* 尚未完成的传输数 */
+static uint16_t lcd_win[4] = { 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF };    /* 屏幕当前的窗口(列起止,行起止),0xFFFF表示未知 */
+static uint16_t lcd_fill_color = 0;                             /* lcd_buf中填充图案的颜色 */
+static uint32_t lcd_fill_pixels = 0;                            /* lcd_buf中填充图案的像素数,0表示无效 */
+
+/* 脏矩形 */
+typedef struct
+{
+    uint16_t sx, sy, ex, ey;                                    /* 对角坐标(含) */
+} lcd_rect_t;
+
+/* 画线时正在累积的像素段 */
+typedef struct
+{
+    int sx, sy;                                                 /* 起点 */
+    int ex, ey;                                                 /* 最后一个点 */
+    uint8_t used;                                               /* 0,空 */
+    uint8_t vert;                                               /* 0,水平段;1,竖直段 */
+} lcd_span_t;
+
+static uint16_t *lcd_fb = NULL;                                 /* 帧缓存(屏幕字节序),NULL表示未打开帧缓存模式 */
+static lcd_rect_t lcd_dirty[LCD_FB_RECTS];                      /* 尚未发送的脏矩形 */
+static uint8_t lcd_dirty_count = 0;                             /* 脏矩形数 */
+
 
 /* LCD需要初始化一组命令/参数值。它们存储在此结构中  */
 typedef struct
@@ -41,14 +67,110 @@ typedef struct
     uint8_t databytes; /* 数据中没有数据；比特7＝设置后的延迟；0xFF=cmds结束 */
 } lcd_init_cmd_t;
 
+/**
+ * @brief       SPI传输开始前的回调(在中断中执行):按传输的user字段设置WR(D/C)引脚
+ * @param       t : 将要开始的传输
+ * @retval      无
+ */
+static void IRAM_ATTR lcd_spi_pre_cb(spi_transaction_t *t)
+{
+    gpio_set_level(LCD_NUM_WR, (t->user == SPI2_USER_CMD) ? 0 : 1);
+}
+
+/**
+ * @brief       等待所有排队发送的传输完成
+ * @note        改用轮询方式发送、或修改已提交发送的数据缓存之前,必须先等队列发完
+ * @param       无
+ * @retval      无
+ */
+void lcd_wait_data(void)
+{
+    while (lcd_async_pending)
+    {
+        spi2_wait_trans(MY_LCD_Handle);
+        lcd_async_pending--;
+    }
+}
+
+/**
+ * @brief       取得一个空闲的传输描述
+ * @note        全部描述都在排队时,等待最早提交的一个完成后复用它
+ * @param       无
+ * @retval      传输描述
+ */
+static spi_transaction_t *lcd_trans_get(void)
+{
+    spi_transaction_t *t;
+
+    if (lcd_async_pending == LCD_QUEUE_SIZE)
+    {
+        spi2_wait_trans(MY_LCD_Handle);
+        lcd_async_pending--;
+    }
+
+    t = &lcd_trans[lcd_trans_next];
+    lcd_trans_next = (lcd_trans_next + 1) % LCD_QUEUE_SIZE;
+    lcd_async_pending++;
+
+    return t;
+}
+
+/**
+ * @brief       以队列方式发送不超过4字节的命令或参数,不等待发送完成
+ * @note        数据复制在传输描述内(SPI_TRANS_USE_TXDATA),返回后data即可复用
+ * @param       user : SPI2_USER_CMD,命令;SPI2_USER_DATA,数据
+ * @param       data : 要发送的数据
+ * @param       len  : 数据长度(1~4)
+ * @retval      无
+ */
+static void lcd_queue_small(void *user, const uint8_t *data, uint8_t len)
+{
+    spi_transaction_t *t = lcd_trans_get();
+
+    memset(t, 0, sizeof(spi_transaction_t));
+    t->flags = SPI_TRANS_USE_TXDATA;
+    t->length = len * 8;
+    t->user = user;
+    memcpy(t->tx_data, data, len);
+    spi2_queue_trans(MY_LCD_Handle, t);
+}
+
+/**
+ * @brief       以DMA队列方式发送数据到LCD，不等待本次传输完成
+ * @note        本次数据排在之前的命令/数据之后由DMA连续发送，函数返回时之前提交的传输都已完成，
+ *              因此调用者用两块缓存交替提交即可：一块在发送的同时准备另一块(乒乓缓存)
+ *              data须位于可DMA的内存中，在下一次调用本函数或lcd_wait_data()之前不能修改
+ * @param       data 要发送的数据
+ * @param       len  数据长度
+ * @retval      无
+ */
+void lcd_write_data_async(const uint8_t *data, int len)
+{
+    if (len == 0)
+    {
+        return;
+    }
+
+    spi2_queue_data(MY_LCD_Handle, lcd_trans_get(), data, len);
+
+    while (lcd_async_pending > 1)                                   /* 只留下刚提交的这一块在发送 */
+    {
+        spi2_wait_trans(MY_LCD_Handle);
+        lcd_async_pending--;
+    }
+}
+
 /**
  * @brief       发送命令到LCD，使用轮询方式阻塞等待传输完成(由于数据传输量很少，因此在轮询方式处理可提高速度。使用中断方式的开销要超过轮询方式)
+ * @note        这样直接发送的命令可能改变窗口(如扫描方向),之后的lcd_set_window会重新设置行列地址
  * @param       cmd 传输的8位命令数据
  * @retval      无
  */
 void lcd_write_cmd(const uint8_t cmd)
 {
-    LCD_WR(0);
+    lcd_wait_data();
+    lcd_win[0] = 0xFFFF;
+    lcd_win[2] = 0xFFFF;
     spi2_write_cmd(MY_LCD_Handle, cmd);
 }
 
@@ -59,12 +181,12 @@ void lcd_write_cmd(const uint8_t cmd)
  */
 void lcd_write_data(const uint8_t *data, int len)
 {
-    LCD_WR(1);
+    lcd_wait_data();
     spi2_write_data(MY_LCD_Handle, data, len);
 }
 
 /**
- * @brief       发送数据到LCD，使用轮询方式阻塞等待传输完成(由于数据传输量很少，因此在轮询方式处理可提高速度。使用中断方式的开销要超过轮询方式)
+ * @brief       发送16位数据到LCD，排在之前的命令/数据之后发送，不等待发送完成
  * @param       data 传输的16位数据
  * @retval      无
  */
@@ -73,12 +195,13 @@ void lcd_write_data16(uint16_t data)
     uint8_t dataBuf[2] = {0,0};
     dataBuf[0] = data >> 8;
     dataBuf[1] = data & 0xFF;
-    LCD_WR(1);
-    spi2_write_data(MY_LCD_Handle, dataBuf,2);
+    lcd_queue_small(SPI2_USER_DATA, dataBuf, 2);
 }
 
 /**
  * @brief       设置窗口大小
+ * @note        命令和参数排入SPI队列(WR由pre_cb按传输设置),CPU不逐个等待;
+ *              列或行范围与屏幕当前窗口相同时不再重发,只剩写GRAM命令
  * @param       xstar：左上角x轴
  * @param       ystar：左上角y轴
  * @param       xend：右下角x轴
@@ -88,75 +211,293 @@ void lcd_write_data16(uint16_t data)
 void lcd_set_window(uint16_t xstar, uint16_t ystar,uint16_t xend,uint16_t yend)
 {	
     uint8_t databuf[4] = {0,0,0,0};
-    databuf[0] = xstar >> 8;
-    databuf[1] = 0xFF & xstar;
-    databuf[2] = xend >> 8;
-    databuf[3] = 0xFF & xend;
-    lcd_write_cmd(lcd_self.setxcmd);
-    lcd_write_data(databuf,4);
-
-    databuf[0] = ystar >> 8;
-    databuf[1] = 0xFF & ystar;
-    databuf[2] = yend >> 8;
-    databuf[3] = 0xFF & yend;
-    lcd_write_cmd(lcd_self.setycmd);
-    lcd_write_data(databuf,4);
-
-    lcd_write_cmd(lcd_self.wramcmd);    /* 开始写入GRAM */
+
+    if (xstar != lcd_win[0] || xend != lcd_win[1])
+    {
+        databuf[0] = lcd_self.setxcmd;
+        lcd_queue_small(SPI2_USER_CMD, databuf, 1);
+        databuf[0] = xstar >> 8;
+        databuf[1] = 0xFF & xstar;
+        databuf[2] = xend >> 8;
+        databuf[3] = 0xFF & xend;
+        lcd_queue_small(SPI2_USER_DATA, databuf, 4);
+        lcd_win[0] = xstar;
+        lcd_win[1] = xend;
+    }
+
+    if (ystar != lcd_win[2] || yend != lcd_win[3])
+    {
+        databuf[0] = lcd_self.setycmd;
+        lcd_queue_small(SPI2_USER_CMD, databuf, 1);
+        databuf[0] = ystar >> 8;
+        databuf[1] = 0xFF & ystar;
+        databuf[2] = yend >> 8;
+        databuf[3] = 0xFF & yend;
+        lcd_queue_small(SPI2_USER_DATA, databuf, 4);
+        lcd_win[2] = ystar;
+        lcd_win[3] = yend;
+    }
+
+    databuf[0] = lcd_self.wramcmd;
+    lcd_queue_small(SPI2_USER_CMD, databuf, 1);     /* 开始写入GRAM */
 }   
 
 /**
- * @brief       以一种颜色清空LCD屏
- * @param       color 清屏颜色
+ * @brief       设置窗口并发送像素数据
+ * @note        窗口命令、参数和像素数据依次排入SPI队列连续发送,返回时数据可能仍在发送(同lcd_write_data_async)
+ * @param       sx,sy,ex,ey : 窗口对角坐标
+ * @param       data        : 像素数据(高字节在前,须位于可DMA的内存中)
+ * @param       len         : 数据长度,应为窗口像素数*2
  * @retval      无
  */
-void lcd_clear(uint16_t color)
+void lcd_write_window(uint16_t sx, uint16_t sy, uint16_t ex, uint16_t ey, const uint8_t *data, int len)
 {
-    uint16_t i, j;
-    uint8_t data[2] = {0};
+    lcd_set_window(sx, sy, ex, ey);
+    lcd_write_data_async(data, len);
+}
 
-    data[0] = color >> 8;
-    data[1] = color;
-    
-    lcd_set_window(0, 0, lcd_self.width - 1, lcd_self.height - 1);
+/**
+ * @brief       准备填充图案:把颜色复制到lcd_buf中
+ * @note        图案的颜色相同且像素数足够时直接复用;复制按1,2,4...像素倍增,只需十几次memcpy
+ * @param       color  : 颜色
+ * @param       pixels : 需要的像素数,最多LCD_BUF_SIZE/2
+ * @retval      无
+ */
+static void lcd_fill_pattern(uint16_t color, uint32_t pixels)
+{
+    uint32_t n;
 
-    for(j = 0; j < LCD_BUF_SIZE / 2; j++)
+    if (pixels > LCD_BUF_SIZE / 2)
     {
-        lcd_buf[j * 2] =  data[0];
-        lcd_buf[j * 2 + 1] =  data[1];
+        pixels = LCD_BUF_SIZE / 2;
     }
 
-    for(i = 0; i < (LCD_TOTAL_BUF_SIZE / LCD_BUF_SIZE); i++)
+    if (lcd_fill_pixels >= pixels && lcd_fill_color == color)
     {
-        lcd_write_data(lcd_buf, LCD_BUF_SIZE);
+        return;
     }
+
+    lcd_wait_data();                                            /* 旧图案可能还在由DMA发送 */
+
+    lcd_buf[0] = color >> 8;                                    /* 高字节在前 */
+    lcd_buf[1] = color & 0xFF;
+
+    for (n = 1; n < pixels; n *= 2)
+    {
+        memcpy(lcd_buf + n * 2, lcd_buf, ((pixels - n < n) ? pixels - n : n) * 2);
+    }
+
+    lcd_fill_color = color;
+    lcd_fill_pixels = pixels;
+}
+
+/**
+ * @brief       把帧缓存中的一个矩形发送到LCD
+ * @note        整个矩形只设置一次窗口,各行依次复制到lcd_buf的两半轮流由DMA发送,复制和发送同时进行
+ * @param       r    : 矩形
+ * @param       half : 先使用lcd_buf的哪一半(另一半可能还在发送)
+ * @retval      下一次应使用的一半
+ */
+static uint8_t lcd_fb_send(const lcd_rect_t *r, uint8_t half)
+{
+    uint16_t w = r->ex - r->sx + 1;
+    uint16_t rows = (LCD_BUF_SIZE / 2) / (w * 2);               /* 每半块的行数 */
+    uint8_t *dst;
+    uint16_t y, n, k;
+
+    lcd_set_window(r->sx, r->sy, r->ex, r->ey);
+
+    for (y = r->sy; y <= r->ey; y += n)
+    {
+        n = (r->ey - y + 1 < rows) ? r->ey - y + 1 : rows;
+        dst = lcd_buf + half * (LCD_BUF_SIZE / 2);              /* 另一半可能还在发送 */
+
+        for (k = 0; k < n; k++)
+        {
+            memcpy(dst + k * w * 2, lcd_fb + (uint32_t)(y + k) * lcd_self.width + r->sx, w * 2);
+        }
+
+        lcd_write_data_async(dst, n * w * 2);                   /* 返回时上一半已发送完成 */
+        half ^= 1;
+    }
+
+    return half;
+}
+
+/**
+ * @brief       记录帧缓存中被修改的矩形
+ * @note        与已有脏矩形重叠或间隔不超过LCD_FB_MERGE_GAP的合并为一个;表满时先把已有的发送出去
+ * @param       sx,sy,ex,ey : 矩形对角坐标(已裁剪到屏幕内)
+ * @retval      无
+ */
+static void lcd_fb_mark(uint16_t sx, uint16_t sy, uint16_t ex, uint16_t ey)
+{
+    lcd_rect_t r = { sx, sy, ex, ey };
+    lcd_rect_t *d;
+    uint8_t i = 0;
+
+    while (i < lcd_dirty_count)
+    {
+        d = &lcd_dirty[i];
+
+        if (r.sx <= d->ex + 1 + LCD_FB_MERGE_GAP && d->sx <= r.ex + 1 + LCD_FB_MERGE_GAP &&
+            r.sy <= d->ey + 1 + LCD_FB_MERGE_GAP && d->sy <= r.ey + 1 + LCD_FB_MERGE_GAP)
+        {
+            r.sx = (d->sx < r.sx) ? d->sx : r.sx;               /* 合并后可能又与别的矩形相邻,从头再查 */
+            r.sy = (d->sy < r.sy) ? d->sy : r.sy;
+            r.ex = (d->ex > r.ex) ? d->ex : r.ex;
+            r.ey = (d->ey > r.ey) ? d->ey : r.ey;
+            *d = lcd_dirty[--lcd_dirty_count];
+            i = 0;
+            continue;
+        }
+
+        i++;
+    }
+
+    if (lcd_dirty_count == LCD_FB_RECTS)
+    {
+        lcd_flush();
+    }
+
+    lcd_dirty[lcd_dirty_count++] = r;
+}
+
+/**
+ * @brief       打开/关闭帧缓存模式
+ * @note        打开后lcd_draw_pixel/lcd_fill/lcd_show_char等绘图函数只画到帧缓存并记录脏矩形,
+ *              由lcd_flush()统一发送;帧缓存初始为LCD_TEXT_BACK,不会读回屏幕内容,打开后一般先重画整个界面,
+ *              直接用lcd_set_window/lcd_write_data_async写屏(如表情动画)的区域不要与帧缓存绘图的区域重叠。
+ *              关闭时先发送剩余的脏区域,再释放帧缓存
+ * @param       en : 1,打开;0,关闭
+ * @retval      0,成功;1,帧缓存内存申请失败(仍直接画到屏幕)
+ */
+uint8_t lcd_fb_enable(uint8_t en)
+{
+    uint32_t pixels = (uint32_t)lcd_self.width * lcd_self.height;
+    uint16_t back = (uint16_t)((LCD_TEXT_BACK >> 8) | (LCD_TEXT_BACK << 8));
+    uint32_t i;
+
+    if (en == 0)
+    {
+        lcd_flush();
+        lcd_wait_data();                                        /* lcd_buf可能还在发送帧缓存的内容 */
+        lcd_mem_free(lcd_fb);
+        lcd_fb = NULL;
+        return 0;
+    }
+
+    if (lcd_fb == NULL)
+    {
+        lcd_fb = (uint16_t *)lcd_mem_alloc(LCD_MEM_FRAME, pixels * 2, "lcd_fb");
+
+        if (lcd_fb == NULL)
+        {
+            return 1;
+        }
+
+        for (i = 0; i < pixels; i++)
+        {
+            lcd_fb[i] = back;
+        }
+
+        lcd_dirty_count = 0;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief       发送帧缓存中所有的脏区域
+ * @note        通常每次界面更新后调用一次;返回时最后一块可能仍在发送;未打开帧缓存模式时不做任何事
+ * @param       无
+ * @retval      无
+ */
+void lcd_flush(void)
+{
+    uint8_t half = 0;
+    uint8_t i;
+
+    if (lcd_dirty_count)
+    {
+        lcd_wait_data();                                        /* lcd_buf可能还在发送填充图案 */
+        lcd_fill_pixels = 0;                                    /* 填充图案被覆盖 */
+    }
+
+    for (i = 0; i < lcd_dirty_count; i++)
+    {
+        half = lcd_fb_send(&lcd_dirty[i], half);
+    }
+
+    lcd_dirty_count = 0;
+}
+
+/**
+ * @brief       以一种颜色清空LCD屏
+ * @param       color 清屏颜色
+ * @retval      无
+ */
+void lcd_clear(uint16_t color)
+{
+    lcd_fill(0, 0, lcd_self.width - 1, lcd_self.height - 1, color);
 }
 
 /**
  * @brief       在指定区域内填充单个颜色
+ * @note        颜色复制到lcd_buf中一次,整个区域只设置一次窗口,再由DMA分几块连续发送同一块图案;
+ *              返回时最后一块可能仍在发送,之后的LCD操作会先等它发送完成(见lcd_wait_data)
  * @param       (sx,sy),(ex,ey):填充矩形对角坐标,区域大小为:(ex - sx + 1) * (ey - sy + 1)
  * @param       color:要填充的颜色(32位颜色,方便兼容LTDC)
  * @retval      无
  */
 void lcd_fill(uint16_t sx, uint16_t sy, uint16_t ex, uint16_t ey, uint16_t color)
 {
-    uint16_t i;
-    uint16_t j;
-    uint16_t width;
-    uint16_t height;
+    uint32_t total;
+    uint32_t n;
 
-    width = ex - sx + 1;
-    height = ey - sy + 1;
-    lcd_set_window(sx, sy, ex, ey);
+    uint16_t *dst;
+    uint16_t x, y;
+
+    if (ex < sx || ey < sy)
+    {
+        return;
+    }
 
-    for (i = 0; i < height; i++)
+    if (lcd_fb)                                                 /* 帧缓存模式:画到帧缓存 */
     {
-        for (j = 0; j < width; j++)
+        if (sx >= lcd_self.width || sy >= lcd_self.height)
+        {
+            return;
+        }
+
+        ex = (ex < lcd_self.width) ? ex : lcd_self.width - 1;
+        ey = (ey < lcd_self.height) ? ey : lcd_self.height - 1;
+        color = (color >> 8) | (color << 8);                    /* 高字节在前 */
+
+        for (y = sy; y <= ey; y++)
         {
-            lcd_write_data16(color);
+            dst = lcd_fb + (uint32_t)y * lcd_self.width;
+
+            for (x = sx; x <= ex; x++)
+            {
+                dst[x] = color;
+            }
         }
+
+        lcd_fb_mark(sx, sy, ex, ey);
+        return;
     }
+
+    total = (uint32_t)(ex - sx + 1) * (ey - sy + 1);
+    lcd_fill_pattern(color, total);
     lcd_set_window(sx, sy, ex, ey);
+
+    while (total > 0)
+    {
+        n = (total > lcd_fill_pixels) ? lcd_fill_pixels : total;
+        lcd_write_data_async(lcd_buf, n * 2);
+        total -= n;
+    }
 }
 
 
@@ -306,12 +647,90 @@ void lcd_hard_reset(void)
  */
 void lcd_draw_pixel(uint16_t x, uint16_t y, uint16_t color)
 {
+    if (lcd_fb)                                                 /* 帧缓存模式:画到帧缓存 */
+    {
+        if (x < lcd_self.width && y < lcd_self.height)
+        {
+            lcd_fb[(uint32_t)y * lcd_self.width + x] = (color >> 8) | (color << 8);
+            lcd_fb_mark(x, y, x, y);
+        }
+
+        return;
+    }
+
     lcd_set_cursor(x, y);
     lcd_write_data16(color);
 }
 
+/**
+ * @brief       画一段水平或竖直的像素段
+ * @note        一段只设置一次窗口、发送一次数据;坐标可以为负或超出屏幕,超出部分裁掉
+ * @param       sx,sy,ex,ey : 两端坐标(不要求有序)
+ * @param       color       : 颜色
+ * @retval      无
+ */
+static void lcd_draw_span(int sx, int sy, int ex, int ey, uint16_t color)
+{
+    int t;
+
+    if (sx > ex)
+    {
+        t = sx;
+        sx = ex;
+        ex = t;
+    }
+
+    if (sy > ey)
+    {
+        t = sy;
+        sy = ey;
+        ey = t;
+    }
+
+    if (ex < 0 || ey < 0 || sx >= lcd_self.width || sy >= lcd_self.height)
+    {
+        return;
+    }
+
+    lcd_fill((sx < 0) ? 0 : sx, (sy < 0) ? 0 : sy, (ex >= lcd_self.width) ? lcd_self.width - 1 : ex,
+             (ey >= lcd_self.height) ? lcd_self.height - 1 : ey, color);
+}
+
+/**
+ * @brief       把一个点加入像素段
+ * @note        与段尾沿段方向相邻的点接到段上,否则先画出已有的段再从该点开始新段;与段尾相同的点忽略
+ * @param       s     : 像素段
+ * @param       x,y   : 坐标
+ * @param       color : 颜色
+ * @retval      无
+ */
+static void lcd_span_point(lcd_span_t *s, int x, int y, uint16_t color)
+{
+    if (s->used)
+    {
+        if (x == s->ex && y == s->ey)
+        {
+            return;
+        }
+
+        if (s->vert ? (x == s->ex && abs(y - s->ey) == 1) : (y == s->ey && abs(x - s->ex) == 1))
+        {
+            s->ex = x;
+            s->ey = y;
+            return;
+        }
+
+        lcd_draw_span(s->sx, s->sy, s->ex, s->ey, color);
+    }
+
+    s->sx = s->ex = x;
+    s->sy = s->ey = y;
+    s->used = 1;
+}
+
 /**
  * @brief       画线函数(直线、斜线)
+ * @note        水平/竖直线直接填充;斜线按原来的步进算点,沿主方向连续的点合并成一段,一段只设置一次窗口
  * @param       x1,y1   起点坐标
  * @param       x2,y2   终点坐标
  * @param       color 填充颜色
@@ -323,6 +742,13 @@ void lcd_draw_line(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t
     int xerr = 0, yerr = 0, delta_x, delta_y, distance; 
     
     int incx, incy, urow, ucol; 
+    lcd_span_t span = {0};
+
+    if (x1 == x2 || y1 == y2)               /* 水平线或垂直线 */
+    {
+        lcd_draw_span(x1, y1, x2, y2, color);
+        return;
+    }
 
     delta_x = x2 - x1;                      /* 计算坐标增量 */
     delta_y = y2 - y1; 
@@ -333,10 +759,6 @@ void lcd_draw_line(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t
     {
         incx = 1;                           /* 设置单步方向 */
     }
-    else if (delta_x == 0)
-    {
-        incx = 0;                           /* 垂直线 */
-    }
     else
     {
         incx =-1;
@@ -346,10 +768,6 @@ void lcd_draw_line(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t
     {
         incy = 1; 
     }
-    else if(delta_y == 0)
-    {
-        incy = 0;                           /* 水平线 */
-    }
     else
     {
         incy =-1;
@@ -364,10 +782,12 @@ void lcd_draw_line(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t
     {
         distance = delta_y; 
     }
+
+    span.vert = (delta_x <= delta_y);       /* 沿主方向合并 */
     
     for (t = 0;t <= distance + 1;t++ )      /* 画线输出 */
     {
-        lcd_draw_pixel(urow,ucol,color);    /* 画点 */ 
+        lcd_span_point(&span, urow, ucol, color);
         xerr += delta_x ; 
         yerr += delta_y ; 
         
@@ -383,6 +803,8 @@ void lcd_draw_line(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t
             ucol += incy; 
         } 
     } 
+
+    lcd_draw_span(span.sx, span.sy, span.ex, span.ey, color);
 }
 
 /**
@@ -416,6 +838,7 @@ void lcd_draw_rectangle(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1,uint1
 
 /**
  * @brief       画一个圆
+ * @note        八个八分圆各自把连续的点合并成水平或竖直的像素段,一段只设置一次窗口
  * @param       x0,y0   圆心坐标
  * @param       r   圆半径
  * @param       color 填充颜色
@@ -423,23 +846,29 @@ void lcd_draw_rectangle(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1,uint1
  */
 void lcd_draw_circle(uint16_t x0, uint16_t y0, uint16_t r, uint16_t color)
 {
+    lcd_span_t span[8] = {0};               /* 每个八分圆一段:上下四个是水平段,左右四个是竖直段 */
     int a, b;
     int di;
+    uint8_t i;
     a = 0;
     b = r;
     di = 3 - (r << 1);
 
+    for (i = 4; i < 8; i++)
+    {
+        span[i].vert = 1;
+    }
+
     while (a <= b)
     {
-        lcd_draw_pixel(x0 - b, y0 - a, color);
-        lcd_draw_pixel(x0 + b, y0 - a, color);
-        lcd_draw_pixel(x0 - a, y0 + b, color);
-        lcd_draw_pixel(x0 - b, y0 - a, color);
-        lcd_draw_pixel(x0 - a, y0 - b, color);
-        lcd_draw_pixel(x0 + b, y0 + a, color);
-        lcd_draw_pixel(x0 + a, y0 - b, color);
-        lcd_draw_pixel(x0 + a, y0 + b, color);
-        lcd_draw_pixel(x0 - b, y0 + a, color);
+        lcd_span_point(&span[4], x0 - b, y0 - a, color);
+        lcd_span_point(&span[5], x0 + b, y0 - a, color);
+        lcd_span_point(&span[0], x0 - a, y0 + b, color);
+        lcd_span_point(&span[1], x0 - a, y0 - b, color);
+        lcd_span_point(&span[6], x0 + b, y0 + a, color);
+        lcd_span_point(&span[2], x0 + a, y0 - b, color);
+        lcd_span_point(&span[3], x0 + a, y0 + b, color);
+        lcd_span_point(&span[7], x0 - b, y0 + a, color);
         a++;
 
         if (di < 0)
@@ -452,121 +881,255 @@ void lcd_draw_circle(uint16_t x0, uint16_t y0, uint16_t r, uint16_t color)
             b--;
         }
 
-        lcd_draw_pixel(x0 + a, y0 + b, color);
+        lcd_span_point(&span[3], x0 + a, y0 + b, color);
+    }
+
+    for (i = 0; i < 8; i++)
+    {
+        if (span[i].used)
+        {
+            lcd_draw_span(span[i].sx, span[i].sy, span[i].ex, span[i].ey, color);
+        }
     }
 }
 
 /**
- * @brief       在指定位置显示一个字符
- * @param       x,y  : 坐标
- * @param       chr  : 要显示的字符:" "--->"~"
+ * @brief       取得字符的点阵
+ * @note        逐行存放,每行(size/2+7)/8字节,高位在左,共size行
+ * @param       chr  : 字符:" "--->"~"
  * @param       size : 字体大小 12/16/24/32
- * @param       mode : 叠加方式(1); 非叠加方式(0);
- * @param       color : 字符的颜色;
- * @retval      无
+ * @retval      点阵数据,NULL表示不支持
  */
-void lcd_show_char(uint16_t x, uint16_t y, uint8_t chr, uint8_t size, uint8_t mode, uint16_t color)
+static const uint8_t *lcd_font_glyph(uint8_t chr, uint8_t size)
 {
-    uint8_t temp = 0,t1 = 0, t = 0;
-    uint8_t *pfont = 0;
-    uint8_t csize = 0;                                      /* 得到字体一个字符对应点阵集所占的字节数 */
-    uint16_t colortemp = 0;
-    uint8_t sta = 0;
-
-    csize = (size / 8 + ((size % 8) ? 1 : 0)) * (size / 2); /* 得到字体一个字符对应点阵集所占的字节数 */
-    chr = chr - ' ';                                        /* 得到偏移后的值（ASCII字库是从空格开始取模，所以-' '就是对应字符的字库） */
-
-    if ((x > (lcd_self.width - size / 2)) || (y > (lcd_self.height - size)))
+    if (chr < ' ' || chr > '~')
     {
-        return;
+        return NULL;
     }
 
-    lcd_set_window(x, y, x + size / 2 - 1, y + size - 1);   /* (x,y,x+8-1,y+16-1) */
-
     switch (size)
     {
         case 12:
-            pfont = (uint8_t *)asc2_1206[chr];              /* 调用1206字体 */
-            sta = 6;
-            break;
+            return asc2_1206[chr - ' '];
 
         case 16:
-            pfont = (uint8_t *)asc2_1608[chr];              /* 调用1608字体 */
-            sta = 8;
-            break;
+            return asc2_1608[chr - ' '];
 
         case 24:
-            pfont = (uint8_t *)asc2_2412[chr];              /* 调用2412字体 */
-            break;
+            return asc2_2412[chr - ' '];
 
         case 32:
-            pfont = (uint8_t *)asc2_3216[chr];              /* 调用3216字体 */
-            sta = 8;
-            break;
+            return asc2_3216[chr - ' '];
 
         default:
-            return ;
+            return NULL;
     }
+}
 
-    if (size != 24)
+/**
+ * @brief       取出点阵的一行,左对齐到32位的最高位
+ * @param       glyph : 点阵数据,NULL按空格处理
+ * @param       row   : 行号
+ * @param       size  : 字体大小 12/16/24/32
+ * @retval      该行的点阵
+ */
+static uint32_t lcd_font_row(const uint8_t *glyph, uint8_t row, uint8_t size)
+{
+    if (glyph == NULL)
     {
-        csize = (size / 8 + ((size % 8) ? 1 : 0)) * (size / 2);
-        
-        for (t = 0; t < csize; t++)
-        {
-            temp = pfont[t];                                /* 获取字符的点阵数据 */
+        return 0;
+    }
+
+    if (size <= 16)                                             /* 每行1字节 */
+    {
+        return (uint32_t)glyph[row] << 24;
+    }
+
+    return ((uint32_t)glyph[row * 2] << 24) | ((uint32_t)glyph[row * 2 + 1] << 16);
+}
+
+/**
+ * @brief       非叠加方式显示一行字符:整行的外接矩形展开到lcd_buf后一次发送
+ * @note        点阵每次取2位查表,一次写入2个像素(32位),字符宽度size/2都是偶数,每行都按字对齐;
+ *              外接矩形超过LCD_BUF_SIZE时按行分块发送,整个区域只设置一次窗口;
+ *              帧缓存模式下展开的各行复制到帧缓存
+ * @param       x,y   : 起点坐标
+ * @param       p     : 字符
+ * @param       n     : 字符数
+ * @param       size  : 字体大小 12/16/24/32
+ * @param       color : 字符的颜色
+ * @param       back  : 背景色
+ * @retval      无
+ */
+static void lcd_text_blit(uint16_t x, uint16_t y, const uint8_t *p, uint16_t n, uint8_t size, uint16_t color, uint16_t back)
+{
+    uint16_t fg = (color >> 8) | (color << 8);                  /* 高字节在前 */
+    uint16_t bg = (back >> 8) | (back << 8);
+    uint16_t w = size / 2;
+    uint16_t rows = LCD_BUF_SIZE / (n * w * 2);                 /* 每块的行数 */
+    uint32_t pair[4];
+    uint32_t *dst;
+    uint32_t bits;
+    uint16_t r, r0, i, c;
+    uint16_t band;
+
+    pair[0] = bg | ((uint32_t)bg << 16);                        /* 小端:低半字是左边的像素 */
+    pair[1] = bg | ((uint32_t)fg << 16);
+    pair[2] = fg | ((uint32_t)bg << 16);
+    pair[3] = fg | ((uint32_t)fg << 16);
+
+    if (lcd_fb == NULL)
+    {
+        lcd_set_window(x, y, x + n * w - 1, y + size - 1);
+    }
 
-            for (t1 = 0; t1 < sta; t1++)
+    for (r0 = 0; r0 < size; r0 += rows)
+    {
+        lcd_wait_data();                                        /* lcd_buf可能还在发送 */
+        lcd_fill_pixels = 0;                                    /* 填充图案被覆盖 */
+        dst = (uint32_t *)lcd_buf;
+
+        for (r = r0; r < size && r < r0 + rows; r++)
+        {
+            for (i = 0; i < n; i++)
             {
-                if (temp & 0x80)
-                {
-                    colortemp = color;
-                }
-                else if (mode == 0)                     /* 无效点,不显示 */
+                bits = lcd_font_row(lcd_font_glyph(p[i], size), r, size);
+
+                for (c = 0; c < w; c += 2)
                 {
-                    colortemp = 0xFFFF;
+                    *dst++ = pair[bits >> 30];
+                    bits <<= 2;
                 }
-
-                lcd_write_data16(colortemp);
-                temp <<= 1;
             }
         }
+
+        if (lcd_fb == NULL)
+        {
+            lcd_write_data_async(lcd_buf, (uint8_t *)dst - lcd_buf);
+            continue;
+        }
+
+        band = r - r0;
+
+        for (r = 0; r < band; r++)                              /* 帧缓存模式:复制到帧缓存 */
+        {
+            memcpy(lcd_fb + (uint32_t)(y + r0 + r) * lcd_self.width + x, lcd_buf + r * n * w * 2, n * w * 2);
+        }
     }
-    else
+
+    if (lcd_fb)
     {
-        csize = (size * 16) / 8;
-        
-        for (t = 0; t < csize; t++)
-        {
-            temp = asc2_2412[chr][t];
+        lcd_fb_mark(x, y, x + n * w - 1, y + size - 1);
+    }
+}
 
-            if (t % 2 == 0)
-            {
-                sta = 8;
-            }
-            else
-            {
-                sta = 4;
-            }
+/**
+ * @brief       叠加方式显示一行字符:只画点阵中的有效点
+ * @note        每行中连续的有效点合并为一段,一段只设置一次窗口
+ * @param       x,y   : 起点坐标
+ * @param       p     : 字符
+ * @param       n     : 字符数
+ * @param       size  : 字体大小 12/16/24/32
+ * @param       color : 字符的颜色
+ * @retval      无
+ */
+static void lcd_text_overlay(uint16_t x, uint16_t y, const uint8_t *p, uint16_t n, uint8_t size, uint16_t color)
+{
+    uint16_t w = size / 2;
+    uint32_t bits;
+    uint16_t r, i, c, s;
+
+    for (r = 0; r < size; r++)
+    {
+        for (i = 0; i < n; i++)
+        {
+            bits = lcd_font_row(lcd_font_glyph(p[i], size), r, size);
 
-            for (t1 = 0; t1 < sta; t1++)
+            for (c = 0; bits; )
             {
-                if(temp & 0x80)
+                while (!(bits & 0x80000000))                    /* 跳过无效点 */
                 {
-                    colortemp = color;
+                    bits <<= 1;
+                    c++;
                 }
-                else if (mode == 0)                         /* 无效点,不显示 */
+
+                for (s = c; bits & 0x80000000; c++)
                 {
-                    colortemp = 0xFFFF;
+                    bits <<= 1;
                 }
 
-                lcd_write_data16(colortemp);
-                temp <<= 1;
+                lcd_fill(x + i * w + s, y + r, x + i * w + c - 1, y + r, color);
             }
         }
     }
 }
 
+/**
+ * @brief       在一行中连续显示n个字符
+ * @note        超出屏幕右边的字符不显示,超出屏幕下边时整行不显示
+ * @param       x,y   : 起点坐标
+ * @param       p     : 字符
+ * @param       n     : 字符数
+ * @param       size  : 字体大小 12/16/24/32
+ * @param       mode  : 叠加方式(1); 非叠加方式(0);
+ * @param       color : 字符的颜色;
+ * @retval      无
+ */
+static void lcd_show_text(uint16_t x, uint16_t y, const uint8_t *p, uint16_t n, uint8_t size, uint8_t mode, uint16_t color)
+{
+    uint16_t w = size / 2;
+
+    if (lcd_font_glyph(' ', size) == NULL || x + w > lcd_self.width || y + size > lcd_self.height)
+    {
+        return;
+    }
+
+    if (n > (lcd_self.width - x) / w)
+    {
+        n = (lcd_self.width - x) / w;
+    }
+
+    if (n == 0)
+    {
+        return;
+    }
+
+    if (mode)
+    {
+        lcd_text_overlay(x, y, p, n, size, color);
+    }
+    else
+    {
+        lcd_text_blit(x, y, p, n, size, color, LCD_TEXT_BACK);
+    }
+}
+
+/**
+ * @brief       在指定位置显示一个字符
+ * @param       x,y  : 坐标
+ * @param       chr  : 要显示的字符:" "--->"~"
+ * @param       size : 字体大小 12/16/24/32
+ * @param       mode : 叠加方式(1); 非叠加方式(0);
+ * @param       color : 字符的颜色;
+ * @retval      无
+ */
+void lcd_show_char(uint16_t x, uint16_t y, uint8_t chr, uint8_t size, uint8_t mode, uint16_t color)
+{
+    lcd_show_text(x, y, &chr, 1, size, mode, color);
+}
+
+/**
+ * @brief       取得ASCII字符的点阵
+ * @note        12/16号字体每行1字节(高位在左),共size行;其他大小不支持
+ * @param       chr  : 字符:" "--->"~"
+ * @param       size : 字体大小 12/16
+ * @retval      点阵数据,NULL表示不支持
+ */
+const uint8_t *lcd_ascii_glyph(uint8_t chr, uint8_t size)
+{
+    return (size == 12 || size == 16) ? lcd_font_glyph(chr, size) : NULL;
+}
+
 /**
  * @brief       m^n函数
  * @param       m,n     输入参数
@@ -582,14 +1145,14 @@ uint32_t lcd_pow(uint8_t m, uint8_t n)
 }
 
 /**
- * @brief       显示len个数字
- * @param       x,y : 起始坐标
- * @param       num : 数值(0 ~ 2^32)
- * @param       len : 显示数字的位数
- * @param       size: 选择字体 12/16/24/32
+ * @brief       把数字转为len个字符,高位的0用fill占位
+ * @param       buf  : 输出的字符
+ * @param       num  : 数值(0 ~ 2^32)
+ * @param       len  : 显示数字的位数
+ * @param       fill : 高位0的占位字符
  * @retval      无
  */
-void lcd_show_num(uint16_t x, uint16_t y, uint32_t num, uint8_t len, uint8_t size, uint16_t color)
+static void lcd_num_text(uint8_t *buf, uint32_t num, uint8_t len, uint8_t fill)
 {
     uint8_t t, temp;
     uint8_t enshow = 0;
@@ -598,24 +1161,34 @@ void lcd_show_num(uint16_t x, uint16_t y, uint32_t num, uint8_t len, uint8_t siz
     {
         temp = (num / lcd_pow(10, len - t - 1)) % 10;                       /* 获取对应位的数字 */
 
-        if (enshow == 0 && t < (len - 1))                                   /* 没有使能显示,且还有位要显示 */
+        if (enshow == 0 && t < (len - 1) && temp == 0)                      /* 没有使能显示,且还有位要显示 */
         {
-            if (temp == 0)
-            {
-                lcd_show_char(x + (size / 2)*t, y, ' ', size, 0, color);    /* 显示空格,占位 */
-                continue;                                                   /* 继续下个一位 */
-            }
-            else
-            {
-                enshow = 1;                                                 /* 使能显示 */
-            }
-
+            buf[t] = fill;
+            continue;
         }
 
-        lcd_show_char(x + (size / 2)*t, y, temp + '0', size, 0, color);     /* 显示字符 */
+        enshow = 1;                                                         /* 使能显示 */
+        buf[t] = temp + '0';
     }
 }
 
+/**
+ * @brief       显示len个数字
+ * @param       x,y : 起始坐标
+ * @param       num : 数值(0 ~ 2^32)
+ * @param       len : 显示数字的位数
+ * @param       size: 选择字体 12/16/24/32
+ * @retval      无
+ */
+void lcd_show_num(uint16_t x, uint16_t y, uint32_t num, uint8_t len, uint8_t size, uint16_t color)
+{
+    uint8_t buf[LCD_NUM_LEN];
+
+    len = (len > LCD_NUM_LEN) ? LCD_NUM_LEN : len;
+    lcd_num_text(buf, num, len, ' ');                                       /* 高位的0显示空格 */
+    lcd_show_text(x, y, buf, len, size, 0, color);
+}
+
 /**
  * @brief       扩展显示len个数字(高位是0也显示)
  * @param       x,y : 起始坐标
@@ -631,34 +1204,11 @@ void lcd_show_num(uint16_t x, uint16_t y, uint32_t num, uint8_t len, uint8_t siz
  */
 void lcd_show_xnum(uint16_t x, uint16_t y, uint32_t num, uint8_t len, uint8_t size, uint8_t mode, uint16_t color)
 {
-    uint8_t t, temp;
-    uint8_t enshow = 0;
+    uint8_t buf[LCD_NUM_LEN];
 
-    for (t = 0; t < len; t++)                                                           /* 按总显示位数循环 */
-    {
-        temp = (num / lcd_pow(10, len - t - 1)) % 10;                                   /* 获取对应位的数字 */
-
-        if (enshow == 0 && t < (len - 1))                                               /* 没有使能显示,且还有位要显示 */
-        {
-            if (temp == 0)
-            {
-                if (mode & 0X80)                                                        /* 高位需要填充0 */
-                {
-                    lcd_show_char(x + (size / 2)*t, y, '0', size, mode & 0X01, color);  /* 用0占位 */
-                }
-                else
-                {
-                    lcd_show_char(x + (size / 2)*t, y, ' ', size, mode & 0X01, color);  /* 用空格占位 */
-                }
-                continue;
-            }
-            else
-            {
-                enshow = 1;                                                             /* 使能显示 */
-            }
-        }
-        lcd_show_char(x + (size / 2)*t, y, temp + '0', size, mode & 0X01, color);
-    }
+    len = (len > LCD_NUM_LEN) ? LCD_NUM_LEN : len;
+    lcd_num_text(buf, num, len, (mode & 0X80) ? '0' : ' ');                /* 高位需要填充0时用0占位,否则用空格 */
+    lcd_show_text(x, y, buf, len, size, mode & 0X01, color);
 }
 
 
@@ -672,7 +1222,8 @@ void lcd_show_xnum(uint16_t x, uint16_t y, uint32_t num, uint8_t len, uint8_t si
  */
 void lcd_show_string(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint8_t size, char *p, uint16_t color)
 {
-    uint8_t x0 = x;
+    uint16_t x0 = x;
+    uint16_t n;
     width += x;
     height += y;
 
@@ -686,9 +1237,11 @@ void lcd_show_string(uint16_t x, uint16_t y, uint16_t width, uint16_t height, ui
 
         if (y >= height)break;  /* 退出 */
 
-        lcd_show_char(x, y, *p, size, 0, color);
-        x += size / 2;
-        p++;
+        for (n = 0; (p[n] <= '~') && (p[n] >= ' ') && (x + n * (size / 2) < width); n++);  /* 本行能放下的字符 */
+
+        lcd_show_text(x, y, (const uint8_t *)p, n, size, 0, color);        /* 整行一次发送 */
+        x += n * (size / 2);
+        p += n;
     }
 }
 
@@ -735,13 +1288,20 @@ void lcd_init(void)
         .clock_speed_hz = 60 * 1000 * 1000,                         /* SPI时钟 */
         .mode = 0,                                                  /* SPI模式0 */
         .spics_io_num = lcd_self.cs,                                /* SPI设备引脚 */
-        .queue_size = 7,                                            /* 事务队列尺寸 7个 */
+        .queue_size = LCD_QUEUE_SIZE,                               /* 事务队列尺寸 7个 */
+        .pre_cb = lcd_spi_pre_cb,                                   /* 每次传输前按user字段设置WR(D/C)引脚 */
     };
     
     /* 添加SPI总线设备 */
     ret = spi_bus_add_device(SPI2_HOST, &devcfg, &MY_LCD_Handle);   /* 配置SPI总线设备 */
     ESP_ERROR_CHECK(ret);
 
+    if (lcd_buf == NULL)
+    {
+        lcd_buf = lcd_mem_alloc(LCD_MEM_LINE, LCD_BUF_SIZE, "lcd_buf");    /* 行缓存 */
+        ESP_ERROR_CHECK((lcd_buf == NULL) ? ESP_ERR_NO_MEM : ESP_OK);
+    }
+
     gpio_init_struct.intr_type = GPIO_INTR_DISABLE;                 /* 失能引脚中断 */
     gpio_init_struct.mode = GPIO_MODE_OUTPUT;                       /* 配置输出模式 */
     gpio_init_struct.pin_bit_mask = 1ull << lcd_self.wr;            /* 配置引脚位掩码 */
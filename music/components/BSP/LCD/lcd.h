@@ -28,9 +28,11 @@
 #include <string.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "esp_attr.h"
 #include "driver/gpio.h"
 #include "xl9555.h"
 #include "spi.h"
+#include "lcd_mem.h"
 
 
 /* 引脚定义 */
@@ -111,13 +113,25 @@ typedef struct _lcd_obj_t
     uint16_t        cs;             /* 片选IO */
 } lcd_obj_t;
 
-/* LCD缓存大小设置，修改此值时请注意！！！！修改这两个值时可能会影响以下函数 lcd_clear/lcd_fill/lcd_draw_line */
-#define LCD_TOTAL_BUF_SIZE      (320 * 240 * 2)
+/* LCD行缓存大小(menuconfig: LCD显示内存 -> 行缓存大小)，修改此值时请注意！！！！可能会影响以下函数 lcd_clear/lcd_fill/lcd_show_string/lcd_flush
+ * lcd_fill每次DMA传输最多LCD_BUF_SIZE字节(填充图案的长度) */
+#ifdef CONFIG_LCD_LINE_BUF_SIZE
+#define LCD_BUF_SIZE            (CONFIG_LCD_LINE_BUF_SIZE & ~3)
+#else
 #define LCD_BUF_SIZE            15360
+#endif
+
+#define LCD_QUEUE_SIZE          7           /* SPI设备的事务队列尺寸,最多同时排队的命令/数据传输数 */
+#define LCD_TEXT_BACK           WHITE       /* 非叠加方式显示字符时的背景色 */
+#define LCD_NUM_LEN             10          /* lcd_show_num/lcd_show_xnum最多显示的位数(32位数值) */
+
+/* 帧缓存模式(见lcd_fb_enable) */
+#define LCD_FB_RECTS            8           /* 最多记录的脏矩形数,表满时自动发送 */
+#define LCD_FB_MERGE_GAP        8           /* 间隔不超过该值(像素)的脏矩形合并成一个发送 */
 
 /* 导出相关变量 */
 extern lcd_obj_t lcd_self;
-extern uint8_t lcd_buf[LCD_TOTAL_BUF_SIZE];
+extern uint8_t *lcd_buf;
 
 /* 函数声明 */
 void lcd_init(void);                                                                                                    /* 初始化LCD */
@@ -125,16 +139,23 @@ void lcd_clear(uint16_t color);
 void lcd_scan_dir(uint8_t dir);                                                                                         /* 设置LCD的自动扫描方向 */
 void lcd_write_data(const uint8_t *data, int len);                                                                      /* 发送数据到LCD */
 void lcd_write_data16(uint16_t data);                                                                                   /* 发送16位数据到LCD */
+void lcd_write_data_async(const uint8_t *data, int len);                                                                /* 以DMA队列方式发送数据到LCD */
+void lcd_wait_data(void);                                                                                               /* 等待排队的数据发送完成 */
 void lcd_set_cursor(uint16_t xpos, uint16_t ypos);                                                                      /* 设置光标的位置 */
 void lcd_set_window(uint16_t xstar, uint16_t ystar,uint16_t xend,uint16_t yend);                                        /* 设置窗口大小 */
+void lcd_write_window(uint16_t sx, uint16_t sy, uint16_t ex, uint16_t ey, const uint8_t *data, int len);                /* 设置窗口并发送像素数据 */
 void lcd_fill(uint16_t sx, uint16_t sy, uint16_t ex, uint16_t ey, uint16_t color);                                      /* 在指定区域内填充单个颜色 */
 void lcd_show_num(uint16_t x, uint16_t y, uint32_t num, uint8_t len, uint8_t size, uint16_t color);                     /* 显示len个数字 */
 void lcd_show_xnum(uint16_t x, uint16_t y, uint32_t num, uint8_t len, uint8_t size, uint8_t mode, uint16_t color);      /* 扩展显示len个数字 */
 void lcd_show_string(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint8_t size, char *p, uint16_t color);   /* 显示字符串 */
+const uint8_t *lcd_ascii_glyph(uint8_t chr, uint8_t size);                                                              /* 取得ASCII字符的点阵 */
 void lcd_draw_rectangle(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1,uint16_t color);                             /* 画一个矩形 */
 void lcd_draw_hline(uint16_t x, uint16_t y, uint16_t len, uint16_t color);                                              /* 画水平线 */
 void lcd_draw_line(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2,uint16_t color);                                  /* 画线函数(直线、斜线) */
+void lcd_draw_circle(uint16_t x0, uint16_t y0, uint16_t r, uint16_t color);                                             /* 画一个圆 */
 void lcd_draw_pixel(uint16_t x, uint16_t y, uint16_t color);                                                            /* 绘画一个像素点 */
 void lcd_show_char(uint16_t x, uint16_t y, uint8_t chr, uint8_t size, uint8_t mode, uint16_t color);                    /* 在指定位置显示一个字符 */
+uint8_t lcd_fb_enable(uint8_t en);                                                                                      /* 打开/关闭帧缓存模式 */
+void lcd_flush(void);                                                                                                   /* 发送帧缓存中的脏区域 */
 
 #endif
@@ -0,0 +1,248 @@
+/**
+ ****************************************************************************************************
+ * @file        lcd_anim.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       动画帧绘制 代码
+ ****************************************************************************************************
+ */
+
+#include <string.h>
+#include "lcd_anim.h"
+
+
+/* 输出块的填充和发送 */
+typedef struct
+{
+    anim_rect_t dst;                        /* 屏幕矩形 */
+    uint32_t pos;                           /* 已发送的像素数(用于叠加层) */
+    uint32_t fill;                          /* 当前块已填充的像素数 */
+    uint8_t buf;                            /* 当前块 */
+} lcd_anim_out_t;
+
+/* 解码乒乓缓存(由lcd_mem申请在可DMA的内部RAM):一块由DMA发送时解码另一块 */
+static uint16_t *lcd_anim_chunk[2];
+static uint16_t *lcd_anim_row = NULL;                          /* 缩放时的源行缓存 */
+
+/**
+ * @brief       申请绘制用的缓存
+ * @note        只在第一次调用时申请,lcd_anim_draw_frame()也会调用;
+ *              提前调用可以让lcd_mem_report()包含这些缓存
+ * @param       无
+ * @retval      0,成功;1,内存不足
+ */
+uint8_t lcd_anim_init(void)
+{
+    if (lcd_anim_chunk[0] == NULL)
+    {
+        lcd_anim_chunk[0] = lcd_mem_alloc(LCD_MEM_LINE, LCD_ANIM_CHUNK_PIXELS * 2 * 2, "lcd_anim_chunk");
+
+        if (lcd_anim_chunk[0] == NULL)
+        {
+            return 1;
+        }
+
+        lcd_anim_chunk[1] = lcd_anim_chunk[0] + LCD_ANIM_CHUNK_PIXELS;
+    }
+
+    if (lcd_anim_row == NULL)
+    {
+        lcd_anim_row = lcd_mem_alloc(LCD_MEM_LINE, LCD_ANIM_ROW_PIXELS * 2, "lcd_anim_row");
+
+        if (lcd_anim_row == NULL)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief       发送当前块:叠加后排入DMA队列,换到另一块继续填充
+ * @param       a : 帧绘制参数
+ * @param       o : 输出状态
+ * @retval      无
+ */
+static void lcd_anim_flush(const lcd_anim_t *a, lcd_anim_out_t *o)
+{
+    if (o->fill == 0)
+    {
+        return;
+    }
+
+    if (a->overlay != NULL)
+    {
+        a->overlay(o->dst.x, o->dst.y, o->dst.w, o->pos, lcd_anim_chunk[o->buf], o->fill);
+    }
+
+    lcd_write_data_async((const uint8_t *)lcd_anim_chunk[o->buf], o->fill * 2);
+    o->pos += o->fill;
+    o->fill = 0;
+    o->buf ^= 1;
+}
+
+/**
+ * @brief       更新影子帧,或与之混合
+ * @note        混合时只修改px(发往屏幕),影子帧保持旧画面,各淡入淡出步骤都以它为起点;
+ *              超出矩形(w*h像素)或影子帧的部分不处理,动画包可能来自SD卡,不能信任其编码数据
+ * @param       a    : 帧绘制参数
+ * @param       rect : 源矩形(帧坐标)
+ * @param       pos  : px[0]在矩形中的序号(按行排列)
+ * @param       px   : 解码出的源像素
+ * @param       len  : 像素数
+ * @retval      无
+ */
+static void lcd_anim_shadow(const lcd_anim_t *a, const anim_rect_t *rect, uint32_t pos, uint16_t *px, uint32_t len)
+{
+    uint16_t *sh;
+    uint32_t col;
+    uint32_t n;
+
+    if (a->shadow == NULL || rect->x + rect->w > a->shadow_w || rect->y + rect->h > a->shadow_h ||
+        pos > (uint32_t)rect->w * rect->h || len > (uint32_t)rect->w * rect->h - pos)
+    {
+        return;
+    }
+
+    while (len > 0)
+    {
+        col = pos % rect->w;
+        n = rect->w - col;
+
+        if (n > len)
+        {
+            n = len;
+        }
+
+        sh = a->shadow + (rect->y + pos / rect->w) * a->shadow_w + rect->x + col;
+
+        if (a->alpha < ANIM_BLEND_MAX)
+        {
+            anim_blend(px, sh, n, a->alpha);
+        }
+        else
+        {
+            memcpy(sh, px, n * 2);
+        }
+
+        pos += n;
+        px += n;
+        len -= n;
+    }
+}
+
+/**
+ * @brief       缩放绘制一个矩形
+ * @note        逐行解码源像素,按映射横向缩放后按需要重复若干行,凑满一块再发送
+ * @param       a    : 帧绘制参数
+ * @param       dec  : 解码器(已取出该矩形)
+ * @param       rect : 源矩形
+ * @param       o    : 输出状态
+ * @retval      无
+ */
+static void lcd_anim_draw_scaled(const lcd_anim_t *a, anim_decoder_t *dec, const anim_rect_t *rect, lcd_anim_out_t *o)
+{
+    const uint16_t *line;
+    uint16_t *out;
+    uint16_t n;
+    uint16_t sy;
+
+    if (rect->w > LCD_ANIM_ROW_PIXELS)
+    {
+        return;                                                 /* 超出行缓存,跳过该矩形(解码器按矩形定位,不影响后续矩形) */
+    }
+
+    for (sy = 0; sy < rect->h; sy++)
+    {
+        if (anim_decode(dec, lcd_anim_row, rect->w) != rect->w)
+        {
+            break;
+        }
+
+        lcd_anim_shadow(a, rect, (uint32_t)sy * rect->w, lcd_anim_row, rect->w);
+        n = anim_blit_rows(&a->blit, rect->y + sy);
+
+        if (n == 0)
+        {
+            continue;                                           /* 缩小时略去的行 */
+        }
+
+        if (o->fill + o->dst.w > LCD_ANIM_CHUNK_PIXELS)
+        {
+            lcd_anim_flush(a, o);
+        }
+
+        out = lcd_anim_chunk[o->buf] + o->fill;
+        anim_blit_row(&a->blit, lcd_anim_row, rect, out);
+        o->fill += o->dst.w;
+        line = out;
+
+        while (--n)                                             /* 放大时重复该行 */
+        {
+            if (o->fill + o->dst.w > LCD_ANIM_CHUNK_PIXELS)
+            {
+                lcd_anim_flush(a, o);                           /* 上一行留在正在发送的块中,DMA只读,仍可从中复制 */
+            }
+
+            out = lcd_anim_chunk[o->buf] + o->fill;
+            memcpy(out, line, o->dst.w * 2);
+            o->fill += o->dst.w;
+            line = out;
+        }
+    }
+}
+
+/**
+ * @brief       绘制一帧
+ * @note        每个脏矩形映射到屏幕后设置一次窗口,再分块解码该矩形的像素,叠加后发送,解码与SPI发送并行;
+ *              alpha小于ANIM_BLEND_MAX时解码出的像素先与影子帧混合,否则同时更新影子帧;
+ *              返回时最后一块可能仍在发送,调用者在释放LCD或再次绘制之前须调用lcd_wait_data()
+ * @param       a     : 帧绘制参数
+ * @param       pack  : 动画包(提供编码方式和调色板)
+ * @param       frame : 帧数据
+ * @param       size  : 帧数据长度
+ * @retval      0,成功;1,帧数据不完整或内存不足
+ */
+uint8_t lcd_anim_draw_frame(lcd_anim_t *a, const anim_pack_t *pack, const uint8_t *frame, uint32_t size)
+{
+    anim_decoder_t dec;
+    anim_rect_t rect;
+    lcd_anim_out_t o;
+    size_t len;
+
+    if (frame == NULL || lcd_anim_init() != 0 || anim_decoder_start_frame(&dec, pack, frame, size) != 0)
+    {
+        return 1;
+    }
+
+    o.buf = 0;
+
+    while (anim_next_rect(&dec, &rect) == 0)
+    {
+        if (anim_blit_rect(&a->blit, &rect, &o.dst) != 0)
+        {
+            continue;                                           /* 整个在窗口外 */
+        }
+
+        lcd_set_window(o.dst.x, o.dst.y, o.dst.x + o.dst.w - 1, o.dst.y + o.dst.h - 1);
+        o.pos = 0;
+        o.fill = 0;
+
+        if (a->blit.scaled || o.dst.w != rect.w || o.dst.h != rect.h)
+        {
+            lcd_anim_draw_scaled(a, &dec, &rect, &o);
+            lcd_anim_flush(a, &o);
+            continue;
+        }
+
+        while ((len = anim_decode(&dec, lcd_anim_chunk[o.buf], LCD_ANIM_CHUNK_PIXELS)) > 0)
+        {
+            lcd_anim_shadow(a, &rect, o.pos, lcd_anim_chunk[o.buf], len);
+            o.fill = len;
+            lcd_anim_flush(a, &o);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,44 @@
+/**
+ ****************************************************************************************************
+ * @file        lcd_anim.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       动画帧绘制 代码
+ *              把ANIM动画包的一帧画到LCD上:每个脏矩形映射到屏幕后设置一次窗口,分块解码后乒乓DMA发送,
+ *              解码与SPI发送并行;1:1且未被裁剪的矩形直接按块解码,需要缩放或裁剪时逐行解码后缩放(见anim_blit)
+ *              可选维护影子帧(交叉淡入淡出时的旧画面)、与影子帧混合,以及在发送前叠加文字层
+ *              表情播放任务(emotion_play.c)和主机端基准测试(tools/anim_bench)共用
+ ****************************************************************************************************
+ */
+
+#ifndef __LCD_ANIM_H
+#define __LCD_ANIM_H
+
+#include <stdint.h>
+#include "lcd.h"
+#include "anim.h"
+#include "anim_blit.h"
+
+
+#define LCD_ANIM_CHUNK_PIXELS   2048        /* 每次SPI传输的像素数(4KB) */
+#define LCD_ANIM_ROW_PIXELS     480         /* 缩放时一行源像素的最大宽度 */
+
+/* 叠加层:在即将发送的像素上叠加内容,参数含义同compose_apply() */
+typedef void (*lcd_anim_overlay_t)(uint16_t x, uint16_t y, uint16_t w, uint32_t pos, uint16_t *pixels, uint32_t len);
+
+/* 帧绘制参数 */
+typedef struct
+{
+    anim_blit_t blit;                       /* 帧到屏幕的映射,由anim_blit_init()设置 */
+    uint16_t *shadow;                       /* 影子帧:按帧坐标保存最近画出的源像素,NULL表示不维护 */
+    uint16_t shadow_w;                      /* 影子帧尺寸,须与动画包的帧尺寸相同 */
+    uint16_t shadow_h;
+    uint8_t alpha;                          /* 新画面的权重,小于ANIM_BLEND_MAX时与影子帧混合(影子帧保持不变) */
+    lcd_anim_overlay_t overlay;             /* 发送前的叠加层,NULL表示不叠加 */
+} lcd_anim_t;
+
+/* 函数声明 */
+uint8_t lcd_anim_init(void);                                                                               /* 申请绘制用的缓存 */
+uint8_t lcd_anim_draw_frame(lcd_anim_t *a, const anim_pack_t *pack, const uint8_t *frame, uint32_t size);   /* 绘制一帧 */
+
+#endif
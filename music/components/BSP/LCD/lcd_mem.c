@@ -0,0 +1,258 @@
+/**
+ ****************************************************************************************************
+ * @file        lcd_mem.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       显示内存管理 代码
+ ****************************************************************************************************
+ */
+
+#include "esp_log.h"
+#include "esp_memory_utils.h"
+#include "lcd_mem.h"
+
+
+static const char *TAG = "lcd_mem";
+
+/* 已申请的缓存 */
+typedef struct
+{
+    void *ptr;                              /* 地址,NULL表示空闲 */
+    uint32_t size;                          /* 字节数 */
+    const char *name;                       /* 用途 */
+    uint8_t type;                           /* 见lcd_mem_type_t */
+    uint8_t psram;                          /* 1,在PSRAM中 */
+} lcd_mem_slot_t;
+
+static lcd_mem_slot_t lcd_mem_slot[LCD_MEM_SLOTS];
+
+/**
+ * @brief       查找记录
+ * @param       ptr : 缓存地址,NULL表示查找空闲记录
+ * @retval      记录,NULL表示没有
+ */
+static lcd_mem_slot_t *lcd_mem_find(const void *ptr)
+{
+    uint8_t i;
+
+    for (i = 0; i < LCD_MEM_SLOTS; i++)
+    {
+        if (lcd_mem_slot[i].ptr == ptr)
+        {
+            return &lcd_mem_slot[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief       按缓存类型和配置从堆中申请内存
+ * @note        帧缓存放在内部RAM时合计不超过LCD_MEM_FRAME_INTERNAL_MAX
+ * @param       type  : 缓存类型
+ * @param       size  : 字节数
+ * @param       psram : 返回1表示申请在PSRAM中
+ * @retval      地址,NULL表示内存不足
+ */
+static void *lcd_mem_heap_alloc(lcd_mem_type_t type, size_t size, uint8_t *psram)
+{
+    lcd_mem_stats_t st;
+    void *p;
+
+    *psram = 0;
+
+    if (type == LCD_MEM_LINE)
+    {
+        return heap_caps_malloc(size, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    }
+
+#if CONFIG_SPIRAM && !CONFIG_LCD_FRAME_MEM_INTERNAL
+    p = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+
+    if (p)
+    {
+        *psram = 1;
+        return p;
+    }
+
+#if CONFIG_LCD_FRAME_MEM_PSRAM
+    return NULL;                                                /* 只用PSRAM */
+#endif
+#endif
+
+    lcd_mem_get_stats(&st);
+
+    if (LCD_MEM_FRAME_INTERNAL_MAX && st.frame_internal + size > LCD_MEM_FRAME_INTERNAL_MAX)
+    {
+        ESP_LOGW(TAG, "internal frame buffers limited to %d bytes (%lu in use)", LCD_MEM_FRAME_INTERNAL_MAX,
+                 (unsigned long)st.frame_internal);
+        return NULL;                                            /* 超出上限,由使用者降级 */
+    }
+
+    p = heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+
+    return p;
+}
+
+/**
+ * @brief       申请显示缓存
+ * @note        LCD_MEM_LINE总在可DMA的内部RAM中,按4字节对齐;LCD_MEM_FRAME按配置优先放在PSRAM,
+ *              放在内部RAM时超出LCD_MEM_FRAME_INTERNAL_MAX则失败
+ * @param       type : 缓存类型
+ * @param       size : 字节数
+ * @param       name : 用途(须为常量字符串),用于lcd_mem_report()
+ * @retval      地址,NULL表示内存不足或记录表已满
+ */
+void *lcd_mem_alloc(lcd_mem_type_t type, size_t size, const char *name)
+{
+    lcd_mem_slot_t *s = lcd_mem_find(NULL);
+
+    if (s == NULL)
+    {
+        ESP_LOGE(TAG, "%s: no free slot", name);
+        return NULL;
+    }
+
+    s->ptr = lcd_mem_heap_alloc(type, size, &s->psram);
+
+    if (s->ptr == NULL)
+    {
+        ESP_LOGW(TAG, "%s: %lu bytes not available", name, (unsigned long)size);
+        return NULL;
+    }
+
+    s->size = size;
+    s->name = name;
+    s->type = type;
+
+    return s->ptr;
+}
+
+/**
+ * @brief       释放显示缓存
+ * @param       ptr : lcd_mem_alloc()返回的地址,NULL时不做任何事
+ * @retval      无
+ */
+void lcd_mem_free(void *ptr)
+{
+    if (ptr == NULL)
+    {
+        return;
+    }
+
+    lcd_mem_detach(ptr);
+    heap_caps_free(ptr);
+}
+
+/**
+ * @brief       登记其他模块申请的缓存,计入统计和lcd_mem_report()
+ * @note        缓存仍由申请者释放,释放前调用lcd_mem_detach();记录表已满时不登记
+ * @param       ptr  : 缓存地址(按地址判断在内部RAM还是PSRAM),NULL时不做任何事
+ * @param       size : 字节数(可以包括同一用途的其他缓存)
+ * @param       name : 用途(须为常量字符串)
+ * @retval      无
+ */
+void lcd_mem_attach(void *ptr, size_t size, const char *name)
+{
+    lcd_mem_slot_t *s;
+
+    if (ptr == NULL)
+    {
+        return;
+    }
+
+    s = lcd_mem_find(NULL);
+
+    if (s == NULL)
+    {
+        ESP_LOGE(TAG, "%s: no free slot", name);
+        return;
+    }
+
+    s->ptr = ptr;
+    s->size = size;
+    s->name = name;
+    s->type = LCD_MEM_ATTACHED;
+    s->psram = esp_ptr_external_ram(ptr) ? 1 : 0;
+}
+
+/**
+ * @brief       取消登记(不释放缓存)
+ * @param       ptr : lcd_mem_attach()登记的地址,NULL或未登记时不做任何事
+ * @retval      无
+ */
+void lcd_mem_detach(void *ptr)
+{
+    lcd_mem_slot_t *s;
+
+    if (ptr != NULL && (s = lcd_mem_find(ptr)) != NULL)
+    {
+        s->ptr = NULL;
+    }
+}
+
+/**
+ * @brief       获取使用统计
+ * @param       stats : 统计数据
+ * @retval      无
+ */
+void lcd_mem_get_stats(lcd_mem_stats_t *stats)
+{
+    uint8_t i;
+
+    stats->internal = 0;
+    stats->psram = 0;
+    stats->frame_internal = 0;
+    stats->reserved = ANIM_CACHE_INTERNAL;
+    stats->count = 0;
+
+    for (i = 0; i < LCD_MEM_SLOTS; i++)
+    {
+        if (lcd_mem_slot[i].ptr)
+        {
+            *(lcd_mem_slot[i].psram ? &stats->psram : &stats->internal) += lcd_mem_slot[i].size;
+
+            if (!lcd_mem_slot[i].psram && lcd_mem_slot[i].type == LCD_MEM_FRAME)
+            {
+                stats->frame_internal += lcd_mem_slot[i].size;
+            }
+
+            stats->count++;
+        }
+    }
+
+    stats->saved = (int32_t)LCD_MEM_BASELINE_SIZE - (int32_t)(stats->internal + stats->reserved);
+}
+
+/**
+ * @brief       报告各缓存的大小和位置,以及堆的剩余空间
+ * @note        最后报告内部RAM的净节省:原来静态的整屏lcd_buf(LCD_MEM_BASELINE_SIZE)减去现在各缓存占用的内部RAM
+ *              和预读缓存在内部RAM中最多占用的字节数,为负数时说明比原来占用的还多;
+ *              SD卡动画包流的缓存只在播放时登记,此时调用才计入
+ * @param       无
+ * @retval      无
+ */
+void lcd_mem_report(void)
+{
+    lcd_mem_stats_t st;
+    uint8_t i;
+
+    for (i = 0; i < LCD_MEM_SLOTS; i++)
+    {
+        if (lcd_mem_slot[i].ptr)
+        {
+            ESP_LOGI(TAG, "%-16s %7lu bytes  %-5s %s", lcd_mem_slot[i].name, (unsigned long)lcd_mem_slot[i].size,
+                     (lcd_mem_slot[i].type == LCD_MEM_LINE) ? "line" : (lcd_mem_slot[i].type == LCD_MEM_FRAME) ? "frame" : "other",
+                     lcd_mem_slot[i].psram ? "PSRAM" : "internal");
+        }
+    }
+
+    lcd_mem_get_stats(&st);
+    ESP_LOGI(TAG, "%d buffers: %lu bytes internal, %lu bytes PSRAM; heap free: %lu internal (%lu DMA), %lu PSRAM",
+             st.count, (unsigned long)st.internal, (unsigned long)st.psram,
+             (unsigned long)heap_caps_get_free_size(MALLOC_CAP_INTERNAL), (unsigned long)heap_caps_get_free_size(MALLOC_CAP_DMA),
+             (unsigned long)heap_caps_get_free_size(MALLOC_CAP_SPIRAM));
+    ESP_LOGI(TAG, "internal RAM: %lu bytes (%lu frame, limit %d) + %lu bytes anim cache vs %d bytes static lcd_buf before, "
+             "net %ld bytes saved", (unsigned long)st.internal, (unsigned long)st.frame_internal, LCD_MEM_FRAME_INTERNAL_MAX,
+             (unsigned long)st.reserved, LCD_MEM_BASELINE_SIZE, (long)st.saved);
+}
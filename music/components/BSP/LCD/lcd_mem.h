@@ -0,0 +1,64 @@
+/**
+ ****************************************************************************************************
+ * @file        lcd_mem.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       显示内存管理 代码
+ *              LCD驱动、表情动画和文字叠加层用到的大块缓存统一由这里申请并记录:
+ *              行缓存由DMA直接发送,放在可DMA的内部RAM;帧缓存只由CPU读写,按menuconfig中
+ *              "LCD显示内存 -> 帧缓存位置"放在PSRAM或内部RAM,放在内部RAM时合计不超过
+ *              "帧缓存占用内部RAM的上限",超出时申请失败,由使用者降级;
+ *              其他模块自行申请的显示相关缓存(如SD卡动画包流的帧缓存)用lcd_mem_attach()登记,一并统计;
+ *              lcd_mem_report()报告各缓存的大小和位置,以及与原来静态整屏缓存相比内部RAM的净节省
+ *              (另扣除预读缓存在内部RAM中最多占用的ANIM_CACHE_INTERNAL字节)
+ ****************************************************************************************************
+ */
+
+#ifndef __LCD_MEM_H
+#define __LCD_MEM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "sdkconfig.h"
+#include "esp_heap_caps.h"
+#include "anim_cache.h"
+
+
+#define LCD_MEM_SLOTS           16          /* 最多记录的缓存数 */
+#define LCD_MEM_BASELINE_SIZE   (320 * 240 * 2) /* 原来静态的整屏lcd_buf,lcd_mem_report()以此计算净节省 */
+
+/* 帧缓存占用内部RAM的上限(menuconfig: LCD显示内存 -> 帧缓存占用内部RAM的上限),0表示不限制 */
+#ifdef CONFIG_LCD_FRAME_MEM_INTERNAL_MAX
+#define LCD_MEM_FRAME_INTERNAL_MAX  CONFIG_LCD_FRAME_MEM_INTERNAL_MAX
+#else
+#define LCD_MEM_FRAME_INTERNAL_MAX  32768
+#endif
+
+/* 缓存类型 */
+typedef enum
+{
+    LCD_MEM_LINE = 0,                       /* 行缓存:DMA直接发送,放在可DMA的内部RAM */
+    LCD_MEM_FRAME,                          /* 帧缓存:只由CPU读写,按配置放在PSRAM或内部RAM */
+    LCD_MEM_ATTACHED,                       /* 其他模块申请的缓存:只登记,不由这里申请和释放 */
+} lcd_mem_type_t;
+
+/* 使用统计 */
+typedef struct
+{
+    uint32_t internal;                      /* 内部RAM中的字节数 */
+    uint32_t psram;                         /* PSRAM中的字节数 */
+    uint32_t frame_internal;                /* 其中放在内部RAM的帧缓存字节数 */
+    uint32_t reserved;                      /* 预读缓存在内部RAM中最多占用的字节数 */
+    int32_t saved;                          /* 与原来静态的整屏lcd_buf相比内部RAM的净节省 */
+    uint8_t count;                          /* 缓存数 */
+} lcd_mem_stats_t;
+
+/* 函数声明 */
+void *lcd_mem_alloc(lcd_mem_type_t type, size_t size, const char *name);   /* 申请显示缓存 */
+void lcd_mem_free(void *ptr);                                               /* 释放显示缓存 */
+void lcd_mem_attach(void *ptr, size_t size, const char *name);              /* 登记其他模块申请的缓存 */
+void lcd_mem_detach(void *ptr);                                             /* 取消登记 */
+void lcd_mem_get_stats(lcd_mem_stats_t *stats);                             /* 获取使用统计 */
+void lcd_mem_report(void);                                                  /* 报告各缓存的大小和位置 */
+
+#endif
@@ -57,6 +57,7 @@ void spi2_write_cmd(spi_device_handle_t handle, uint8_t cmd)
 
     t.length = 8;                                       /* 要传输的位数 一个字节 8位 */
     t.tx_buffer = &cmd;                                 /* 将命令填充进去 */
+    t.user = SPI2_USER_CMD;                             /* 由设备的pre_cb设置为命令 */
     ret = spi_device_polling_transmit(handle, &t);      /* 开始传输 */
     ESP_ERROR_CHECK(ret);                               /* 一般不会有问题 */
 }
@@ -80,10 +81,65 @@ void spi2_write_data(spi_device_handle_t handle, const uint8_t *data, int len)
 
     t.length = len * 8;                             /* 要传输的位数 一个字节 8位 */
     t.tx_buffer = data;                             /* 将命令填充进去 */
+    t.user = SPI2_USER_DATA;                        /* 由设备的pre_cb设置为数据 */
     ret = spi_device_polling_transmit(handle, &t);  /* 开始传输 */
     ESP_ERROR_CHECK(ret);                           /* 一般不会有问题 */
 }
 
+/**
+ * @brief       SPI以队列方式发送数据(DMA),不等待传输完成
+ * @note        传输完成前t和data都不能释放或修改,完成后用spi2_wait_trans()取回
+ * @param       handle : SPI句柄
+ * @param       t      : 传输描述,由调用者提供
+ * @param       data   : 要发送的数据(须位于可DMA的内存中)
+ * @param       len    : 要发送的数据长度
+ * @retval      无
+ */
+void spi2_queue_data(spi_device_handle_t handle, spi_transaction_t *t, const uint8_t *data, int len)
+{
+    esp_err_t ret;
+
+    memset(t, 0, sizeof(spi_transaction_t));
+    t->length = len * 8;                                        /* 要传输的位数 一个字节 8位 */
+    t->tx_buffer = data;
+    t->user = SPI2_USER_DATA;
+    ret = spi_device_queue_trans(handle, t, portMAX_DELAY);     /* 加入传输队列,由DMA在后台发送 */
+    ESP_ERROR_CHECK(ret);
+}
+
+/**
+ * @brief       SPI以队列方式发送一次由调用者填好的传输,不等待传输完成
+ * @note        用于数据放在t->tx_data中的短传输,或需要自行设置user字段(命令/数据)的传输;
+ *              传输完成前t不能释放或修改,完成后用spi2_wait_trans()取回
+ * @param       handle : SPI句柄
+ * @param       t      : 传输描述
+ * @retval      无
+ */
+void spi2_queue_trans(spi_device_handle_t handle, spi_transaction_t *t)
+{
+    esp_err_t ret;
+
+    ret = spi_device_queue_trans(handle, t, portMAX_DELAY);
+    ESP_ERROR_CHECK(ret);
+}
+
+/**
+ * @brief       等待最早排队的一次传输完成
+ * @note        等待期间任务阻塞在驱动的完成队列上,不占用CPU
+ * @param       handle : SPI句柄
+ * @retval      完成的传输描述
+ */
+spi_transaction_t *spi2_wait_trans(spi_device_handle_t handle)
+{
+    esp_err_t ret;
+    spi_transaction_t *t = NULL;
+
+    ret = spi_device_get_trans_result(handle, &t, portMAX_DELAY);
+    ESP_ERROR_CHECK(ret);
+
+    return t;
+}
+
 /**
  * @brief       SPI处理数据
  * @param       handle       : SPI句柄
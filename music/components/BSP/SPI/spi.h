@@ -32,9 +32,16 @@
 #define SPI_CLK_GPIO_PIN    GPIO_NUM_12         /* SPI2_CLK */
 #define SPI_MISO_GPIO_PIN   GPIO_NUM_13         /* SPI2_MISO */
 
+/* 传输的user字段,设备的pre_cb据此设置命令/数据引脚(见lcd.c) */
+#define SPI2_USER_CMD       ((void *)0)         /* 命令 */
+#define SPI2_USER_DATA      ((void *)1)         /* 数据 */
+
 /* 函数声明 */
 void spi2_init(void);                                                               /* 初始化SPI2 */
 void spi2_write_cmd(spi_device_handle_t handle, uint8_t cmd);                       /* SPI发送命令 */
 void spi2_write_data(spi_device_handle_t handle, const uint8_t *data, int len);     /* SPI发送数据 */
 uint8_t spi2_transfer_byte(spi_device_handle_t handle, uint8_t byte);               /* SPI处理数据 */
+void spi2_queue_data(spi_device_handle_t handle, spi_transaction_t *t, const uint8_t *data, int len);   /* SPI以队列方式发送数据 */
+void spi2_queue_trans(spi_device_handle_t handle, spi_transaction_t *t);            /* SPI以队列方式发送一次传输 */
+spi_transaction_t *spi2_wait_trans(spi_device_handle_t handle);                     /* 等待一次排队传输完成 */
 #endif
@@ -0,0 +1,194 @@
+/**
+ ****************************************************************************************************
+ * @file        audio_meter.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       音频电平分析 代码
+ ****************************************************************************************************
+ */
+
+#include <math.h>
+#include <string.h>
+#include "audio_meter.h"
+
+
+static audio_meter_t audio_meter;           /* 最新的分析结果 */
+static volatile uint32_t audio_meter_seq = 0;   /* 发布序号,奇数表示正在写入 */
+
+/* 以下只由music任务访问 */
+static uint32_t audio_meter_rate = 0;       /* 滤波系数对应的采样率 */
+static float audio_meter_a_low;             /* 低通滤波系数(低频段) */
+static float audio_meter_a_high;            /* 低通滤波系数(高频段的分界) */
+static float audio_meter_lp_low = 0;        /* 滤波器状态 */
+static float audio_meter_lp_high = 0;
+static uint32_t audio_meter_blocks = 0;
+
+/**
+ * @brief       计算一阶低通滤波系数
+ * @param       fc   : 截止频率(Hz)
+ * @param       rate : 分析的采样率(Hz)
+ * @retval      滤波系数
+ */
+static float audio_meter_alpha(float fc, float rate)
+{
+    return 1.0f - expf(-2.0f * (float)M_PI * fc / rate);
+}
+
+/**
+ * @brief       均方值转换为0~32767的电平
+ * @param       sum   : 平方和
+ * @param       count : 采样数
+ * @retval      电平
+ */
+static uint16_t audio_meter_level(float sum, uint32_t count)
+{
+    float v = sqrtf(sum / count);
+
+    return (v > 32767.0f) ? 32767 : (uint16_t)v;
+}
+
+/**
+ * @brief       发布分析结果
+ * @note        写入前后各把序号加1,读取方在序号为奇数或前后不一致时重读,双方都不需要加锁
+ * @param       m : 分析结果
+ * @retval      无
+ */
+static void audio_meter_publish(const audio_meter_t *m)
+{
+    audio_meter_seq++;
+    __sync_synchronize();
+    audio_meter = *m;
+    __sync_synchronize();
+    audio_meter_seq++;
+}
+
+/**
+ * @brief       清除分析结果(换曲/停止)
+ * @param       无
+ * @retval      无
+ */
+void audio_meter_reset(void)
+{
+    audio_meter_t m;
+
+    memset(&m, 0, sizeof(m));
+    audio_meter_lp_low = 0;
+    audio_meter_lp_high = 0;
+    audio_meter_blocks = 0;
+    audio_meter_publish(&m);
+}
+
+/**
+ * @brief       分析一块PCM数据
+ * @note        在music任务中调用,声道混合为单声道后每AUDIO_METER_STEP帧取一个采样,
+ *              只取每个采样的高16位,16/24/32位数据都可处理
+ * @param       pcm        : PCM数据(小端)
+ * @param       len        : 数据长度(字节)
+ * @param       bps        : 采样位数
+ * @param       nchannels  : 声道数
+ * @param       samplerate : 采样率
+ * @retval      无
+ */
+void audio_meter_process(const uint8_t *pcm, uint32_t len, uint16_t bps, uint16_t nchannels, uint32_t samplerate)
+{
+    audio_meter_t m;
+    uint32_t bytes = bps / 8;
+    uint32_t frame = bytes * nchannels;
+    uint32_t step = frame * AUDIO_METER_STEP;
+    uint32_t count = 0;
+    uint32_t peak = 0;
+    uint32_t i;
+    uint16_t ch;
+    int32_t mix;
+    float x;
+    float low;
+    float high;
+    float sum = 0;
+    float sum_low = 0;
+    float sum_mid = 0;
+    float sum_high = 0;
+
+    if (bytes < 2 || nchannels == 0 || samplerate == 0 || len < frame)
+    {
+        return;
+    }
+
+    if (samplerate != audio_meter_rate)                     /* 采样率变化时重新计算滤波系数 */
+    {
+        audio_meter_rate = samplerate;
+        audio_meter_a_low = audio_meter_alpha(AUDIO_METER_LOW_HZ, (float)samplerate / AUDIO_METER_STEP);
+        audio_meter_a_high = audio_meter_alpha(AUDIO_METER_HIGH_HZ, (float)samplerate / AUDIO_METER_STEP);
+    }
+
+    low = audio_meter_lp_low;
+    high = audio_meter_lp_high;
+
+    for (i = 0; i + frame <= len; i += step)
+    {
+        mix = 0;
+
+        for (ch = 0; ch < nchannels; ch++)                  /* 取各声道采样的高16位 */
+        {
+            mix += (int16_t)(pcm[i + ch * bytes + bytes - 2] | (pcm[i + ch * bytes + bytes - 1] << 8));
+        }
+
+        mix /= nchannels;
+
+        if ((uint32_t)(mix < 0 ? -mix : mix) > peak)
+        {
+            peak = (mix < 0) ? -mix : mix;
+        }
+
+        x = (float)mix;
+        low += audio_meter_a_low * (x - low);               /* 低频段:低通 */
+        high += audio_meter_a_high * (x - high);            /* 高频段:x减去低通 */
+        sum += x * x;
+        sum_low += low * low;
+        sum_mid += (high - low) * (high - low);
+        sum_high += (x - high) * (x - high);
+        count++;
+    }
+
+    audio_meter_lp_low = low;
+    audio_meter_lp_high = high;
+
+    m.rms = audio_meter_level(sum, count);
+    m.peak = (peak > 32767) ? 32767 : peak;
+    m.band[0] = audio_meter_level(sum_low, count);
+    m.band[1] = audio_meter_level(sum_mid, count);
+    m.band[2] = audio_meter_level(sum_high, count);
+    m.blocks = ++audio_meter_blocks;
+    audio_meter_publish(&m);
+}
+
+/**
+ * @brief       读取最新的分析结果
+ * @param       meter : 分析结果
+ * @retval      0,成功;1,本曲还没有分析结果(或一直与写入冲突)
+ */
+uint8_t audio_meter_get(audio_meter_t *meter)
+{
+    uint32_t seq;
+    uint8_t retry;
+
+    for (retry = 0; retry < 4; retry++)
+    {
+        seq = audio_meter_seq;
+        __sync_synchronize();
+
+        if (seq & 1)                                        /* 正在写入 */
+        {
+            continue;
+        }
+
+        *meter = audio_meter;
+        __sync_synchronize();
+
+        if (seq == audio_meter_seq)
+        {
+            return (meter->blocks == 0) ? 1 : 0;
+        }
+    }
+
+    return 1;
+}
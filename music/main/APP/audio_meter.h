@@ -0,0 +1,38 @@
+/**
+ ****************************************************************************************************
+ * @file        audio_meter.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       音频电平分析 代码
+ *              music任务每写入一块PCM数据到I2S,顺便计算该块的RMS、峰值和低/中/高三个频段的电平,
+ *              结果通过序号(seqlock)无锁发布,动画任务随时读取最新一块的分析结果
+ *              频段由一阶IIR滤波器划分(ESP32-S3有单精度FPU),每个采样只需十几次浮点运算
+ ****************************************************************************************************
+ */
+
+#ifndef __AUDIO_METER_H
+#define __AUDIO_METER_H
+
+#include <stdint.h>
+
+
+#define AUDIO_METER_BANDS       3           /* 频段数:低/中/高 */
+#define AUDIO_METER_LOW_HZ      250         /* 低频段上限(Hz) */
+#define AUDIO_METER_HIGH_HZ     4000        /* 高频段下限(Hz) */
+#define AUDIO_METER_STEP        1           /* 每隔几个采样帧分析一次(高采样率时可加大以降低运算量) */
+
+/* 一块PCM数据的分析结果,电平均为0~32767(满幅) */
+typedef struct
+{
+    uint16_t rms;                           /* 均方根电平 */
+    uint16_t peak;                          /* 峰值 */
+    uint16_t band[AUDIO_METER_BANDS];       /* 各频段均方根电平:低/中/高 */
+    uint32_t blocks;                        /* 本曲已分析的块数 */
+} audio_meter_t;
+
+/* 函数声明 */
+void audio_meter_reset(void);                                                   /* 清除分析结果(换曲/停止) */
+void audio_meter_process(const uint8_t *pcm, uint32_t len, uint16_t bps, uint16_t nchannels, uint32_t samplerate);   /* 分析一块PCM数据 */
+uint8_t audio_meter_get(audio_meter_t *meter);                                  /* 读取最新的分析结果 */
+
+#endif
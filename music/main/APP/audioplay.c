@@ -20,6 +20,7 @@
 
 #include "audioplay.h"
 #include "emotion_play.h"  // ͷļ
+#include "compose.h"
 
 __audiodev g_audiodev;          /* ֲſ */
 
@@ -94,10 +95,12 @@ uint16_t audio_get_tnum(uint8_t *path)
  */
 void audio_index_show(uint16_t index, uint16_t total)
 {
+    char buf[16];
+
     /* ʾǰĿ,Ŀ */
-    lcd_show_num(30 + 0, 230, index, 3, 16, RED);   /*  */
-    lcd_show_char(30 + 24, 230, '/', 16, 0, RED);
-    lcd_show_num(30 + 32, 230, total, 3, 16, RED);  /* Ŀ */
+    sprintf(buf, "%3u/%3u", index, total);
+    compose_set_text(COMPOSE_INDEX, buf);
+    compose_flush();
 }
 
 /**
@@ -110,26 +113,23 @@ void audio_index_show(uint16_t index, uint16_t total)
 void audio_msg_show(uint32_t totsec, uint32_t cursec, uint32_t bitrate)
 {
     static uint16_t playtime = 0xFFFF;                                  /* ʱ */
+    char buf[24];
     
     if (playtime != cursec)                                             /* Ҫʾʱ */
     {
         playtime = cursec;
         
-        /* ʾʱ */
-        lcd_show_xnum(30, 210, playtime / 60, 2, 16, 0X80, RED);        /*  */
-        lcd_show_char(30 + 16, 210, ':', 16, 0, RED);
-        lcd_show_xnum(30 + 24, 210, playtime % 60, 2, 16, 0X80, RED);   /*  */
-        lcd_show_char(30 + 40, 210, '/', 16, 0, RED);
-        
-        /* ʾʱ */
-        lcd_show_xnum(30 + 48, 210, totsec / 60, 2, 16, 0X80, RED);     /*  */
-        lcd_show_char(30 + 64, 210, ':', 16, 0, RED);
-        lcd_show_xnum(30 + 72, 210, totsec % 60, 2, 16, 0X80, RED);     /*  */
+        /* ʱ/ʱ */
+        sprintf(buf, "%02u:%02u/%02u:%02u", (unsigned)(playtime / 60) % 100, (unsigned)(playtime % 60),
+                (unsigned)(totsec / 60) % 100, (unsigned)(totsec % 60));
+        compose_set_text(COMPOSE_TIME, buf);
         
-        /* ʾλ */
-        lcd_show_num(30 + 110, 210, bitrate / 1000, 4, 16, RED);/* ʾλ */
-        lcd_show_string(30 + 110 + 32 , 210, 200, 16, 16, "Kbps", RED);
+        /* λ */
+        sprintf(buf, "%4luKbps", (unsigned long)(bitrate / 1000) % 10000);
+        compose_set_text(COMPOSE_BITRATE, buf);
     }
+
+    compose_flush();                                                    /* LCDռʱɶһ֡ػ */
 }
 
 /**
@@ -225,6 +225,8 @@ void audio_play(void)
     uint8_t key;                                                /* ֵ */
     uint32_t temp;
     uint32_t *wavoffsettbl;                                     /* offset */
+    track_meta_t *wavmetatbl;                                   /* Ԫݱ,offsetһһӦ */
+    char *sidecar;                                              /* Ԫļ */
 
     es8388_adda_cfg(1, 0);                                      /* DACرADC */
     es8388_output_cfg(1, 1);                                    /* DACѡͨ1 */
@@ -250,8 +252,9 @@ void audio_play(void)
     wavfileinfo = (FILINFO*)malloc(sizeof(FILINFO));            /* ڴ */
     pname = malloc(255 * 2 + 1);                                /* Ϊ·ļڴ */
     wavoffsettbl = malloc(4 * totwavnum);                       /* 4*totwavnumֽڵڴ,ڴļoff block */
+    wavmetatbl = malloc(sizeof(track_meta_t) * totwavnum);      /* Ԫݱ */
     
-    while (!wavfileinfo || !pname || !wavoffsettbl)             /* ڴ */
+    while (!wavfileinfo || !pname || !wavoffsettbl || !wavmetatbl)  /* ڴ */
     {
         text_show_string(30, 190, 240, 16, "ڴʧ!", 16, 0, BLUE);
         vTaskDelay(200);
@@ -259,7 +262,8 @@ void audio_play(void)
         vTaskDelay(200);
     }
     
-    /* ¼ */
+    /* ¼,ͬʱĿԪ(ʱֱӰȡ) */
+    sidecar = track_meta_load_sidecar("0:/MUSIC");              /* Ԫļ(û) */
     res = f_opendir(&wavdir, "0:/MUSIC");                       /* Ŀ¼ */
     
     if (res == FR_OK)
@@ -282,11 +286,16 @@ void audio_play(void)
             if ((res & 0xF0) == 0x40)                           /* ȡλ,ǲļ */
             {
                 wavoffsettbl[curindex] = temp;                   /* ¼ */
+                strcpy((char *)pname, "0:/MUSIC/");
+                strcat((char *)pname, (const char *)wavfileinfo->fname);
+                track_meta_get((char *)pname, (char *)wavfileinfo->fname, sidecar, &wavmetatbl[curindex]);
                 curindex++;
             }
         }
     }
     
+    free(sidecar);
+    
     curindex = 0;                                               /* 0ʼʾ */
     res = f_opendir(&wavdir, (const TCHAR*)"0:/MUSIC");         /* Ŀ¼ */
     
@@ -302,10 +311,10 @@ void audio_play(void)
         
         strcpy((char *)pname, "0:/MUSIC/");                     /* ·(Ŀ¼) */
         strcat((char *)pname, (const char *)wavfileinfo->fname);/* ļں */
-        lcd_fill(30, 190, lcd_self.width - 1, 190 + 16, WHITE); /* ֮ǰʾ */
+        compose_set_text(COMPOSE_TITLE, (char *)wavfileinfo->fname);   /* ʾ */
         audio_index_show(curindex + 1, totwavnum);
-        text_show_string(30, 190, lcd_self.width - 60, 16, (char *)wavfileinfo->fname, 16, 0, BLUE);   /* ʾ */
-        key = audio_play_song(pname);                           /* Ƶļ */
+        emotion_prefetch((emotion_id_t)wavmetatbl[(curindex + 1) % totwavnum].emotion);   /* ǰһ׵ı鶯 */
+        key = audio_play_song(pname, &wavmetatbl[curindex]);    /* Ƶļ */
         
         if (key == KEY2_PRES)                                   /* һ */
         {
@@ -336,17 +345,19 @@ void audio_play(void)
     free(wavfileinfo);                                          /* ͷڴ */
     free(pname);                                                /* ͷڴ */
     free(wavoffsettbl);                                         /* ͷڴ */
+    free(wavmetatbl);                                           /* ͷڴ */
 }
 
 /**
  * @brief       ĳƵļ
  * @param       fname : ļ
+ * @param       meta  : ĿԪ,NULLʾû
  * @retval      ֵ
  *   @arg       KEY0_PRES , һ.
  *   @arg       KEY2_PRES , һ.
  *   @arg        , 
  */
-uint8_t audio_play_song(uint8_t *fname)
+uint8_t audio_play_song(uint8_t *fname, const track_meta_t *meta)
 {
     uint8_t res;  
     
@@ -355,7 +366,7 @@ uint8_t audio_play_song(uint8_t *fname)
     switch (res)
     {
         case T_WAV:
-            res = wav_play_song(fname);
+            res = wav_play_song(fname, meta);
             break;
         case T_MP3:
             /* ʵ */
@@ -27,6 +27,7 @@
 #include "i2s.h"
 #include "lcd.h"
 #include "text.h"
+#include "track_meta.h"
 
 
 /* 音乐播放控制器 */
@@ -50,6 +51,6 @@ uint16_t audio_get_tnum(uint8_t *path);                                     /* 
 void audio_index_show(uint16_t index, uint16_t total);                      /* 显示曲目索引 */
 void audio_msg_show(uint32_t totsec, uint32_t cursec, uint32_t bitrate);    /* 显示播放时间,比特率 信息 */
 void audio_play(void);                                                      /* 播放音乐 */
-uint8_t audio_play_song(uint8_t *fname);                                    /* 播放某个音频文件 */
+uint8_t audio_play_song(uint8_t *fname, const track_meta_t *meta);          /* 播放某个音频文件 */
 
 #endif
@@ -0,0 +1,388 @@
+/**
+ ****************************************************************************************************
+ * @file        compose.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       画面合成 代码
+ ****************************************************************************************************
+ */
+
+#include "compose.h"
+#include "text.h"
+#include "emotion_play.h"
+
+
+/* 叠加层 */
+typedef struct
+{
+    uint16_t x, y, w, h;                    /* 区域 */
+    uint16_t color;                         /* 文字颜色(屏幕字节序) */
+    uint8_t changed;                        /* 文字已修改,点阵尚未更新 */
+    uint8_t redraw;                         /* 需要重绘 */
+    uint8_t direct;                         /* 缓存申请失败,文字不叠加到动画上,直接画到屏幕 */
+    char text[COMPOSE_TEXT_LEN];            /* 最新设置的文字 */
+    uint8_t *mask;                          /* 文字点阵,每像素1位 */
+    uint16_t *back;                         /* 背景像素(屏幕字节序) */
+} compose_layer_t;
+
+/* 各叠加层的位置和颜色 */
+static const struct
+{
+    uint16_t x, y, w;
+    uint16_t color;
+} compose_cfg[COMPOSE_LAYERS] = {
+    [COMPOSE_TITLE]   = { 30,  190, 260, BLUE },
+    [COMPOSE_TIME]    = { 30,  210, 88,  RED },
+    [COMPOSE_BITRATE] = { 140, 210, 64,  RED },
+    [COMPOSE_INDEX]   = { 250, 210, 56,  RED },
+};
+
+static compose_layer_t compose_layer[COMPOSE_LAYERS];
+static portMUX_TYPE compose_spinlock = portMUX_INITIALIZER_UNLOCKED;
+
+/* 行带乒乓缓存(由lcd_mem申请在可DMA的内部RAM) */
+static uint16_t *compose_band[2];
+
+/**
+ * @brief       RGB565颜色转换为屏幕字节序
+ * @param       color : 颜色
+ * @retval      屏幕字节序的颜色
+ */
+static uint16_t compose_swap(uint16_t color)
+{
+    return (color >> 8) | (color << 8);
+}
+
+/**
+ * @brief       点阵中置位一个像素
+ * @param       l    : 叠加层
+ * @param       x, y : 层内坐标
+ * @retval      无
+ */
+static void compose_mask_set(compose_layer_t *l, uint16_t x, uint16_t y)
+{
+    uint32_t k;
+
+    if (x < l->w && y < l->h)
+    {
+        k = (uint32_t)y * l->w + x;
+        l->mask[k >> 3] |= 0x80 >> (k & 7);
+    }
+}
+
+/**
+ * @brief       按文字生成叠加层点阵
+ * @note        ASCII字符取LCD驱动的字库,汉字(GBK)取字库分区,超出层宽度的部分截掉
+ * @param       l    : 叠加层
+ * @param       text : 文字
+ * @retval      无
+ */
+static void compose_render(compose_layer_t *l, const char *text)
+{
+    const uint8_t *p = (const uint8_t *)text;
+    const uint8_t *glyph;
+    uint8_t mat[COMPOSE_FONT_SIZE * 2];
+    uint16_t x = 0;
+    uint16_t r, c;
+
+    memset(l->mask, 0, ((uint32_t)l->w * l->h + 7) / 8);
+
+    while (*p != 0 && x < l->w)
+    {
+        if (*p > 0x80 && p[1] != 0)                         /* 汉字:逐列,每列2字节 */
+        {
+            text_get_hz_mat((unsigned char *)p, mat, COMPOSE_FONT_SIZE);
+
+            for (c = 0; c < COMPOSE_FONT_SIZE; c++)
+            {
+                for (r = 0; r < COMPOSE_FONT_SIZE; r++)
+                {
+                    if (mat[c * 2 + r / 8] & (0x80 >> (r % 8)))
+                    {
+                        compose_mask_set(l, x + c, r);
+                    }
+                }
+            }
+
+            x += COMPOSE_FONT_SIZE;
+            p += 2;
+        }
+        else                                                /* ASCII:逐行,每行1字节 */
+        {
+            glyph = lcd_ascii_glyph(*p, COMPOSE_FONT_SIZE);
+
+            for (r = 0; glyph && r < COMPOSE_FONT_SIZE; r++)
+            {
+                for (c = 0; c < COMPOSE_FONT_SIZE / 2; c++)
+                {
+                    if (glyph[r] & (0x80 >> c))
+                    {
+                        compose_mask_set(l, x + c, r);
+                    }
+                }
+            }
+
+            x += COMPOSE_FONT_SIZE / 2;
+            p++;
+        }
+    }
+}
+
+/**
+ * @brief       重绘一个叠加层
+ * @note        按行带合成背景和文字,每个行带设置一次窗口、一次DMA传输
+ * @param       l : 叠加层
+ * @retval      无
+ */
+static void compose_draw(compose_layer_t *l)
+{
+    uint16_t rows = COMPOSE_BAND_PIXELS / l->w;
+    uint16_t y, n;
+    uint32_t k, i, len;
+    uint8_t buf = 0;
+
+    for (y = 0; y < l->h; y += n)
+    {
+        n = (l->h - y < rows) ? l->h - y : rows;
+        len = (uint32_t)n * l->w;
+        k = (uint32_t)y * l->w;
+
+        for (i = 0; i < len; i++, k++)
+        {
+            compose_band[buf][i] = (l->mask[k >> 3] & (0x80 >> (k & 7))) ? l->color : l->back[k];
+        }
+
+        lcd_write_window(l->x, l->y + y, l->x + l->w - 1, l->y + y + n - 1, (const uint8_t *)compose_band[buf], len * 2);
+        buf ^= 1;
+    }
+
+    lcd_wait_data();
+}
+
+/**
+ * @brief       初始化叠加层
+ * @note        在lcd_init()之后调用,超出屏幕的部分截掉;
+ *              某一层缓存申请失败时,该层改为像以前一样直接画到屏幕,其余层不受影响;
+ *              行带缓存申请失败时所有层都直接画到屏幕
+ * @param       无
+ * @retval      0,成功;1,内存不足(部分叠加层改为直接绘制)
+ */
+uint8_t compose_init(void)
+{
+    compose_layer_t *l;
+    uint32_t i, size;
+    uint8_t id;
+    uint8_t res = 0;
+
+    if (compose_band[0] == NULL)
+    {
+        compose_band[0] = lcd_mem_alloc(LCD_MEM_LINE, COMPOSE_BAND_PIXELS * 2 * 2, "compose_band");
+        compose_band[1] = (compose_band[0] != NULL) ? compose_band[0] + COMPOSE_BAND_PIXELS : NULL;
+    }
+
+    for (id = 0; id < COMPOSE_LAYERS; id++)
+    {
+        l = &compose_layer[id];
+        memset(l, 0, sizeof(compose_layer_t));
+        l->x = compose_cfg[id].x;
+        l->y = compose_cfg[id].y;
+        l->w = compose_cfg[id].w;
+        l->h = COMPOSE_FONT_SIZE;
+        l->color = compose_swap(compose_cfg[id].color);
+
+        if (l->x >= lcd_self.width || l->y + l->h > lcd_self.height)
+        {
+            l->w = 0;                                       /* 不在屏幕内,不显示 */
+            continue;
+        }
+
+        if (l->x + l->w > lcd_self.width)
+        {
+            l->w = lcd_self.width - l->x;
+        }
+
+        size = (uint32_t)l->w * l->h;
+
+        if (compose_band[0] != NULL)
+        {
+            l->mask = calloc(1, (size + 7) / 8);
+            l->back = lcd_mem_alloc(LCD_MEM_FRAME, size * 2, "compose_back");
+        }
+
+        if (l->mask == NULL || l->back == NULL)
+        {
+            free(l->mask);
+            lcd_mem_free(l->back);
+            l->mask = NULL;
+            l->back = NULL;
+            l->direct = 1;
+            res = 1;
+            continue;
+        }
+
+        for (i = 0; i < size; i++)
+        {
+            l->back[i] = compose_swap(COMPOSE_BACK_COLOR);
+        }
+    }
+
+    return res;
+}
+
+/**
+ * @brief       设置叠加层文字
+ * @note        可在任意任务中调用,只记录文字,由compose_update()在持有LCD时生成点阵并重绘
+ * @param       id   : 叠加层编号
+ * @param       text : 文字(GBK),与当前文字相同时不重绘
+ * @retval      无
+ */
+void compose_set_text(uint8_t id, const char *text)
+{
+    compose_layer_t *l;
+
+    if (id >= COMPOSE_LAYERS)
+    {
+        return;
+    }
+
+    l = &compose_layer[id];
+
+    taskENTER_CRITICAL(&compose_spinlock);
+
+    if (strncmp(l->text, text, COMPOSE_TEXT_LEN - 1) != 0)
+    {
+        strncpy(l->text, text, COMPOSE_TEXT_LEN - 1);
+        l->text[COMPOSE_TEXT_LEN - 1] = 0;
+        l->changed = 1;
+    }
+
+    taskEXIT_CRITICAL(&compose_spinlock);
+}
+
+/**
+ * @brief       在即将发送的动画像素上叠加文字
+ * @note        被文字区域覆盖的动画像素先存为该层的背景,文字变化时用来重绘;须持有lcd_mutex
+ * @param       x, y   : 动画矩形在屏幕上的左上角
+ * @param       w      : 动画矩形宽度
+ * @param       pos    : pixels[0]在矩形中的序号(按行排列)
+ * @param       pixels : 像素(屏幕字节序),叠加结果直接写回
+ * @param       len    : 像素数
+ * @retval      无
+ */
+void compose_apply(uint16_t x, uint16_t y, uint16_t w, uint32_t pos, uint16_t *pixels, uint32_t len)
+{
+    compose_layer_t *l;
+    uint32_t i = 0;
+    uint32_t n, k;
+    uint16_t py, px0, px1, a, b, px;
+    uint8_t id;
+
+    while (i < len)
+    {
+        py = y + (pos + i) / w;                             /* 本段所在的行和列范围 */
+        px0 = x + (pos + i) % w;
+        n = x + w - px0;
+        n = (n < len - i) ? n : len - i;
+        px1 = px0 + n;
+
+        for (id = 0; id < COMPOSE_LAYERS; id++)
+        {
+            l = &compose_layer[id];
+
+            if (l->w == 0 || l->direct || py < l->y || py >= l->y + l->h)
+            {
+                continue;
+            }
+
+            a = (px0 > l->x) ? px0 : l->x;
+            b = (px1 < l->x + l->w) ? px1 : l->x + l->w;
+
+            for (px = a; px < b; px++)
+            {
+                k = (uint32_t)(py - l->y) * l->w + (px - l->x);
+                l->back[k] = pixels[i + px - px0];
+
+                if (l->mask[k >> 3] & (0x80 >> (k & 7)))
+                {
+                    pixels[i + px - px0] = l->color;
+                }
+            }
+        }
+
+        i += n;
+    }
+}
+
+/**
+ * @brief       重绘有变化的叠加层
+ * @note        须持有lcd_mutex;动画任务每帧绘制后调用一次
+ * @param       无
+ * @retval      无
+ */
+void compose_update(void)
+{
+    compose_layer_t *l;
+    char text[COMPOSE_TEXT_LEN];
+    uint8_t changed;
+    uint8_t id;
+
+    for (id = 0; id < COMPOSE_LAYERS; id++)
+    {
+        l = &compose_layer[id];
+
+        if (l->w == 0)
+        {
+            continue;
+        }
+
+        taskENTER_CRITICAL(&compose_spinlock);
+        changed = l->changed;
+
+        if (changed)
+        {
+            memcpy(text, l->text, COMPOSE_TEXT_LEN);
+            l->changed = 0;
+        }
+
+        taskEXIT_CRITICAL(&compose_spinlock);
+
+        if (l->direct)                                      /* 没有点阵和背景缓存,擦除后直接写字 */
+        {
+            if (changed)
+            {
+                lcd_fill(l->x, l->y, l->x + l->w - 1, l->y + l->h - 1, COMPOSE_BACK_COLOR);
+                text_show_string(l->x, l->y, l->w, l->h, text, COMPOSE_FONT_SIZE, 0, compose_cfg[id].color);
+                lcd_wait_data();                            /* lcd_fill()的最后一块可能仍在发送,释放LCD之前须等待 */
+            }
+
+            continue;
+        }
+
+        if (changed)
+        {
+            compose_render(l, text);
+            l->redraw = 1;
+        }
+
+        if (l->redraw)
+        {
+            compose_draw(l);
+            l->redraw = 0;
+        }
+    }
+}
+
+/**
+ * @brief       LCD空闲时重绘有变化的叠加层
+ * @note        LCD正被动画任务占用时直接返回,由动画任务在本帧绘制后重绘,调用者不会被阻塞
+ * @param       无
+ * @retval      无
+ */
+void compose_flush(void)
+{
+    if (lcd_mutex != NULL && xSemaphoreTake(lcd_mutex, 0) == pdTRUE)
+    {
+        compose_update();
+        xSemaphoreGive(lcd_mutex);
+    }
+}
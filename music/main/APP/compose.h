@@ -0,0 +1,43 @@
+/**
+ ****************************************************************************************************
+ * @file        compose.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       画面合成 代码
+ *              屏幕由动画层和若干文字叠加层(播放时间/位率/曲目索引/歌名)组成:
+ *              动画解码出的每块像素在发送前叠加上文字,文字区域只随动画一起发送一次;
+ *              文字变化时按行带(band)把保存的动画背景和文字合成后整块DMA发送,不再先擦除再逐点写字
+ *              每个叠加层保存一份文字点阵(1位)和该区域的背景像素(动画最近一帧或背景色)
+ ****************************************************************************************************
+ */
+
+#ifndef __COMPOSE_H
+#define __COMPOSE_H
+
+#include <stdint.h>
+#include "lcd.h"
+
+
+#define COMPOSE_FONT_SIZE       16          /* 叠加层字体大小 */
+#define COMPOSE_TEXT_LEN        64          /* 叠加层文字最大长度(字节,含结束符) */
+#define COMPOSE_BAND_PIXELS     2048        /* 行带缓存像素数,每个行带一次DMA传输 */
+#define COMPOSE_BACK_COLOR      WHITE       /* 动画未覆盖区域的背景色 */
+
+/* 叠加层编号 */
+typedef enum
+{
+    COMPOSE_TITLE = 0,                      /* 歌名 */
+    COMPOSE_TIME,                           /* 播放时间/总时间 */
+    COMPOSE_BITRATE,                        /* 位率 */
+    COMPOSE_INDEX,                          /* 曲目索引/总数 */
+    COMPOSE_LAYERS
+} compose_layer_id_t;
+
+/* 函数声明 */
+uint8_t compose_init(void);                                                     /* 初始化叠加层 */
+void compose_set_text(uint8_t id, const char *text);                            /* 设置叠加层文字(任意任务) */
+void compose_apply(uint16_t x, uint16_t y, uint16_t w, uint32_t pos, uint16_t *pixels, uint32_t len);  /* 在动画像素上叠加文字 */
+void compose_update(void);                                                      /* 重绘有变化的叠加层(须持有lcd_mutex) */
+void compose_flush(void);                                                       /* LCD空闲时重绘有变化的叠加层 */
+
+#endif
@@ -1,121 +1,604 @@
 #include "emotion_play.h"
+#include "wavplay.h"
+#include "esp_timer.h"
+#include "compose.h"
+#include <string.h>
+#include <strings.h>
 
 TaskHandle_t emotion_task_handle = NULL;
-static volatile bool is_playing = false;
 SemaphoreHandle_t lcd_mutex = NULL;
+static portMUX_TYPE emotion_spinlock = portMUX_INITIALIZER_UNLOCKED;
+static anim_pace_t emotion_pace;        // 帧节奏与统计（入场→循环→退场连续排期）
 
+// 表情描述表：新增表情只需在此加一行（并准备对应的动画包），无需新增任务
+static const emotion_desc_t emotion_table[EMOTION_COUNT] = {
+    [EMOTION_HAPPY] = { "happy", "excited_in", "excited_loop", "excited_out", 0, 40, EMOTION_FLAG_OUT_ON_SWITCH | EMOTION_FLAG_XFADE },
+    [EMOTION_SAD]   = { "sad",   "sad_in",     "sad_loop",     "sad_out",     0, 20, EMOTION_FLAG_OUT_ON_SWITCH | EMOTION_FLAG_XFADE },
+};
 
-// 分块绘制一帧（避免SPI传输过长）
-static void lcd_draw_frame(const uint16_t *frame)
+// 播放命令
+typedef struct {
+    uint8_t cmd;                        // EMOTION_CMD_xxx
+    uint8_t id;                         // 表情编号
+    uint16_t bpm;                       // 曲目节拍，0表示未知
+    uint32_t seq;                       // 命令序号，应答时原样返回
+    TaskHandle_t sender;                // 发送命令的任务，接收后以任务通知应答
+} emotion_cmd_t;
+
+static QueueHandle_t emotion_queue = NULL;      // 命令队列
+
+// 以下状态只由播放任务访问
+static uint8_t emotion_request = EMOTION_NONE;  // 请求播放的表情
+static bool emotion_request_fast = false;       // 请求快速切换（不等入场/退场序列播完）
+static uint8_t emotion_current = EMOTION_NONE;  // 正在播放的表情
+static uint16_t emotion_bpm = 0;                // 当前曲目的节拍，循环序列按此调整节奏
+
+static volatile uint8_t emotion_hint = EMOTION_NONE;    // 接下来可能播放的表情（任意任务设置）
+
+
+// 帧绘制参数（见lcd_anim）：当前动画包到屏幕的映射、影子帧、混合权重和文字叠加层
+static lcd_anim_t emotion_anim = {
+    .shadow_w = FRAME_WIDTH,
+    .shadow_h = FRAME_HEIGHT,
+    .alpha = ANIM_BLEND_MAX,            // 小于ANIM_BLEND_MAX时与影子帧混合
+    .overlay = compose_apply,
+};
+
+// 影子帧：按帧坐标保存屏幕上当前动画画面的源像素（叠加文字层之前），交叉淡入淡出时作为旧画面
+static uint16_t *emotion_shadow = NULL;         // FRAME_WIDTH*FRAME_HEIGHT像素，未开启或申请失败时不做淡入淡出
+static bool emotion_shadow_ok = false;          // 当前动画包尺寸与影子帧一致
+static bool emotion_shadow_fresh = false;       // 影子帧与屏幕画面一致（画过关键帧之后）
+static bool emotion_xfade = false;              // 上一个表情已跳过退场，下一个表情淡入
+
+// 绘制一帧（解码、缩放、影子帧和文字叠加层见lcd_anim_draw_frame），文字变化的叠加层随后单独重绘
+// 返回前等待发送完成，调用者释放lcd_mutex后其他任务即可直接操作LCD
+static void lcd_draw_frame(const anim_pack_t *pack, const uint8_t *frame, uint32_t size)
 {
-    const size_t chunk_size = 4096;
-    size_t total_size = FRAME_WIDTH * FRAME_HEIGHT * 2; // RGB565格式，每个像素2字节
-    const uint8_t *data = (const uint8_t *)frame;
+    lcd_anim_draw_frame(&emotion_anim, pack, frame, size);
+    compose_update();
+    lcd_wait_data();
+}
 
-    for (size_t offset = 0; offset < total_size; offset += chunk_size)
-    {
-        size_t len = (offset + chunk_size <= total_size) ? chunk_size : (total_size - offset);
-        lcd_write_data(data + offset, len);
+// 按名字查找常驻地址空间的动画包：先查Flash动画分区（mmap，不占用RAM），再查固件内置
+static bool find_expression(const char *name, const uint8_t **anim, uint32_t *size) {
+    if (anim_flash_find(name, anim, size) == 0) {
+        return true;
+    }
+#if EMOTION_BUILTIN_ANIM
+    if (anim_bundle_find(emotion_anims, EMOTION_ANIMS_SIZE, name, anim, size) == 0) {
+        return true;
     }
+#endif
+    return false;
 }
 
-// 动画播放通用函数
-static void play_expression(const uint16_t **frames, int frame_count, int delay_ms) {
-    for (int i = 0; i < frame_count && is_playing; i++) {
-        // 申请LCD控制权（最多等待100ms，避免死等）
-        if (xSemaphoreTake(lcd_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-            lcd_set_window(0, 0, FRAME_WIDTH - 1, FRAME_HEIGHT - 1);
-            lcd_draw_frame(frames[i]);
-            xSemaphoreGive(lcd_mutex);  // 释放控制权
+// 执行一条命令，并通知发送方命令已接收
+static void emotion_apply(const emotion_cmd_t *cmd)
+{
+    emotion_request = (cmd->cmd == EMOTION_CMD_STOP) ? EMOTION_NONE : cmd->id;
+    emotion_request_fast = (cmd->cmd == EMOTION_CMD_SWITCH);
+
+    if (cmd->cmd != EMOTION_CMD_STOP) {
+        emotion_bpm = cmd->bpm;
+    }
+
+    if (cmd->sender != NULL) {
+        xTaskNotify(cmd->sender, cmd->seq, eSetValueWithOverwrite);
+    }
+}
+
+// 动画排期时钟：有音频在播放时跟随音频的实际播放进度（见wav_get_clock），否则使用系统时间
+// 切换时钟来源或换曲时重新对齐，返回值保持连续，排期不会因此跳变
+static int64_t emotion_clock(void)
+{
+    static int64_t last = 0;            // 上次返回值
+    static int64_t base = 0;            // 对齐时刻的返回值
+    static int64_t ref = 0;             // 对齐时刻的时钟来源读数
+    static int64_t prev = 0;            // 上次的时钟来源读数
+    static uint8_t src = 0xFF;          // 时钟来源：0,音频；1,系统时间
+    int64_t t;
+    uint8_t cur;
+
+    cur = (wav_get_clock(&t) == 0) ? 0 : 1;
+
+    if (cur) {
+        t = esp_timer_get_time();
+    }
+
+    if (cur != src || t < prev) {       // 来源变化，或播放位置倒退（换曲）
+        src = cur;
+        base = last;
+        ref = t;
+    }
+
+    prev = t;
+    last = base + (t - ref);
+
+    return last;
+}
+
+// 等待到当前排期时刻，等待期间阻塞在命令队列上，命令到达后立即处理
+// 音频卡顿时排期时钟走得比系统时间慢，超时后重新计算，直到时钟到达排期时刻或需要切换表情
+static void emotion_sleep(void)
+{
+    emotion_cmd_t cmd;
+    uint32_t ticks;
+
+    while (1) {
+        ticks = anim_pace_ticks(&emotion_pace);
+
+        if (xQueueReceive(emotion_queue, &cmd, ticks) == pdTRUE) {
+            emotion_apply(&cmd);
+
+            if (emotion_request != emotion_current) {
+                return;
+            }
+        } else if (ticks == 0) {
+            return;
         }
-        vTaskDelay(pdMS_TO_TICKS(delay_ms));
     }
 }
 
-// 开心动画任务
-static void happy_emotion_task(void *param)
+// 判断当前序列是否应中途退出
+// EMOTION_LEAVE_SWITCH: 请求了其他表情（或停止）即退出，用于循环序列
+// EMOTION_LEAVE_FAST:   只有快速切换才退出，用于入场/退场序列
+static bool emotion_leave(emotion_leave_t leave)
 {
-    is_playing = true;
-        // 1. 播放入场帧（必须执行完，不响应退出）
-    play_expression((const uint16_t **)excited_in_frames, EXCITED_IN_FRAME_COUNT, 100);
-    
-    // 2. 循环播放（响应退出信号）
-    while (is_playing) {
-        play_expression((const uint16_t **)excited_loop_frames, EXCITED_LOOP_FRAME_COUNT, 100);
-        // 每次循环后检查退出信号，避免卡帧
-        if (!is_playing) break;
+    if (leave == EMOTION_LEAVE_SWITCH) {
+        return emotion_request != emotion_current;
     }
-    
-    // 3. 播放退场帧（必须执行完，保证动画完整性）
-    play_expression((const uint16_t **)excited_out_frames, EXCITED_OUT_FRAME_COUNT, 100);
-    
-    // 4. 任务退出前重置状态
-    is_playing = false;
-    emotion_task_handle = NULL;  // 关键：标记任务已退出
-    vTaskDelete(NULL);
+
+    return emotion_request != emotion_current && emotion_request_fast;
 }
 
-// 难过动画任务
-static void sad_emotion_task(void *param)
+// 按音乐的实时响度缩短帧时长：静音时保持原速，RMS达到EMOTION_REACT_FULL时缩短react_pct%
+static uint16_t emotion_react(uint16_t duration, uint8_t react_pct)
 {
-    is_playing = true;
-    // 播放入场→循环→退场完整流程
-    play_expression((const uint16_t **)sad_in_frames, SAD_IN_FRAME_COUNT, 100);
-    while (is_playing) // 循环播放，直到音频结束
-    {
-        play_expression((const uint16_t **)sad_loop_frames, SAD_LOOP_FRAME_COUNT, 100);
+    audio_meter_t meter;
+    uint32_t level;
+
+    if (react_pct == 0 || audio_meter_get(&meter) != 0) {
+        return duration;
     }
-    play_expression((const uint16_t **)sad_out_frames, SAD_OUT_FRAME_COUNT, 100);
-    is_playing = false;
-    emotion_task_handle = NULL;
-    vTaskDelete(NULL);
+
+    level = (meter.rms > EMOTION_REACT_FULL) ? EMOTION_REACT_FULL : meter.rms;
+
+    return duration - (uint32_t)duration * react_pct * level / (100UL * EMOTION_REACT_FULL);
 }
 
-// 启动开心动画
-void play_happy_emotion(void)
+// 按曲目节拍缩放循环序列的帧时长：动画按EMOTION_TEMPO_REF拍/分钟制作，节拍越快播放越快
+// 缩放比例限制在EMOTION_TEMPO_MIN_PCT%~EMOTION_TEMPO_MAX_PCT%之间，节拍未知时保持原速
+static uint16_t emotion_tempo(uint16_t duration)
 {
-    stop_emotion_task(); // 先停止已有动画
-    xTaskCreate(
-        happy_emotion_task,
-        "happy_emotion",
-        8192,
-        NULL,
-        3, // 优先级低于音频任务
-        &emotion_task_handle
-    );
+    uint32_t pct;
+
+    if (emotion_bpm == 0) {
+        return duration;
+    }
+
+    pct = 100UL * EMOTION_TEMPO_REF / emotion_bpm;
+
+    if (pct < EMOTION_TEMPO_MIN_PCT) {
+        pct = EMOTION_TEMPO_MIN_PCT;
+    } else if (pct > EMOTION_TEMPO_MAX_PCT) {
+        pct = EMOTION_TEMPO_MAX_PCT;
+    }
+
+    return (uint32_t)duration * pct / 100;
 }
 
-// 启动难过动画
-void play_sad_emotion(void)
+// 交叉淡入淡出：从影子帧（上一个表情最后显示的画面）过渡到本序列的首帧（关键帧）
+// 每一步重新解码首帧并逐块与影子帧混合后发送，不需要额外的帧缓存；最后一步（完全显示首帧）由调用者正常绘制
+static void emotion_crossfade(const anim_pack_t *pack, const uint8_t *frame, uint32_t size)
 {
-    stop_emotion_task(); // 先停止已有动画
-    xTaskCreate(
-        sad_emotion_task,
-        "sad_emotion",
-        8192,
-        NULL,
-        3, // 优先级低于音频任务
-        &emotion_task_handle
-    );
+    uint8_t step;
+
+    for (step = 1; step < EMOTION_XFADE_STEPS && !emotion_leave(EMOTION_LEAVE_FAST); step++) {
+        emotion_anim.alpha = step * ANIM_BLEND_MAX / EMOTION_XFADE_STEPS;
+        xSemaphoreTake(lcd_mutex, portMAX_DELAY);
+        lcd_draw_frame(pack, frame, size);
+        xSemaphoreGive(lcd_mutex);
+        emotion_anim.alpha = ANIM_BLEND_MAX;
+        anim_pace_advance(&emotion_pace, EMOTION_XFADE_MS / EMOTION_XFADE_STEPS);
+        emotion_sleep();
+    }
 }
 
-// 停止动画任务
+// SD卡动画包流：循环序列每轮都播放同一个包，打开一次后一直保持到表情结束（或换成另一个包），
+// 不必每轮重新打开文件、申请帧缓存；预读时已确认SD卡上没有的包（见anim_cache_missing）
+// 和本表情中打不开的包都不再重复查找
+static anim_stream_t emotion_stream;
+static const char *emotion_stream_name = NULL;      // 已打开的动画包名，NULL表示未打开
+static const char *emotion_stream_absent = NULL;    // 本表情中最近一个打不开的动画包名
 
-void stop_emotion_task(void) {
-    if (emotion_task_handle != NULL) {
-        is_playing = false;  // 通知任务退出循环
-        // 等待任务自行删除（最多等待100ms，避免死等）
-        for (int i = 0; i < 10; i++) {
-            if (emotion_task_handle == NULL) {
-                break;  // 任务已退出，跳出循环
+// 关闭SD卡动画包流
+static void emotion_stream_close(void)
+{
+    if (emotion_stream_name != NULL) {
+        lcd_mem_detach(emotion_stream.buf[0]);
+        anim_stream_close(&emotion_stream);
+        emotion_stream_name = NULL;
+    }
+}
+
+// 打开SD卡动画包流，已打开的同名包直接复用
+static bool emotion_stream_open(const char *name)
+{
+    if (emotion_stream_name != NULL && strcmp(emotion_stream_name, name) == 0) {
+        return true;
+    }
+
+    if ((emotion_stream_absent != NULL && strcmp(emotion_stream_absent, name) == 0) || anim_cache_missing(name)) {
+        return false;
+    }
+
+    emotion_stream_close();
+
+    if (anim_stream_open(&emotion_stream, name) != 0) {
+        emotion_stream_absent = name;
+        return false;
+    }
+
+    // 文件、包头和帧双缓存都在堆上，登记到显示缓存统计中（见lcd_mem_report）
+    lcd_mem_attach(emotion_stream.buf[0], sizeof(FIL) + emotion_stream.head_size + emotion_stream.buf_size * 2,
+                   "anim_stream");
+    emotion_stream_name = name;
+    return true;
+}
+
+// 动画播放通用函数
+// name: 动画名，优先使用预读缓存中的SD卡动画包（见anim_cache），其次从SD卡 0:/ANIM/<name>.anm 流式读取，
+//       再次Flash动画分区，最后固件内置
+// wrap: 屏幕上正显示本序列的末帧（循环播放），首帧可用回环差分帧代替关键帧
+// leave: 在什么情况下中途退出本序列（见emotion_leave）
+// react_pct: 帧时长随音乐响度缩短的最大百分比（见emotion_react）
+// fade: 从屏幕上的旧画面交叉淡入本序列的首帧（见emotion_crossfade）
+// 每帧显示时长取自动画包的帧信息表，按emotion_pace的绝对时刻排期（跟随音频播放进度，见emotion_clock）
+static void play_expression(const char *name, bool wrap, emotion_leave_t leave, uint8_t react_pct, bool fade) {
+    anim_pack_t pack;
+    const anim_pack_t *p;
+    const uint8_t *anim;
+    const uint8_t *cached;
+    const uint8_t *frame;
+    uint32_t size;
+    uint32_t frame_size;
+    uint32_t offset;
+    uint16_t index;
+    uint16_t next;
+    uint16_t duration;
+    uint16_t frame_flags;
+    uint16_t next_duration;
+    uint16_t next_flags;
+    uint8_t skippable;
+    bool streaming;
+
+    if (name == NULL) {
+        return;
+    }
+
+    cached = anim_cache_get(name, &size);
+    streaming = false;
+
+    if (cached != NULL && anim_pack_open(&pack, cached, size) == 0) {
+        p = &pack;                      // 已预读到内存，按常驻动画包播放
+    } else if ((streaming = emotion_stream_open(name))) {
+        p = &emotion_stream.pack;
+    } else if (find_expression(name, &anim, &size) && anim_pack_open(&pack, anim, size) == 0) {
+        p = &pack;
+    } else {
+        printf("动画包%s不存在或解析失败\n", name);
+        anim_cache_put(cached);
+        return;
+    }
+
+    // 帧按EMOTION_BLIT_MODE缩放/居中到整个屏幕
+    anim_blit_init(&emotion_anim.blit, p->width, p->height, 0, 0, lcd_self.width, lcd_self.height, EMOTION_BLIT_MODE);
+    emotion_shadow_ok = (emotion_shadow != NULL && p->width == FRAME_WIDTH && p->height == FRAME_HEIGHT);
+    emotion_anim.shadow = emotion_shadow_ok ? emotion_shadow : NULL;
+
+    if (!emotion_shadow_ok) {
+        emotion_shadow_fresh = false;
+    }
+
+    for (int i = 0; i < p->frame_count && !emotion_leave(leave); i++) {
+        index = (i == 0 && wrap && (p->flags & ANIM_FLAG_LOOP)) ? p->frame_count : i;
+        anim_frame_meta(p, index, &duration, &frame_flags);
+        duration = emotion_react(duration, react_pct);
+
+        if (leave == EMOTION_LEAVE_SWITCH) {
+            duration = emotion_tempo(duration);     // 只有循环序列跟随节拍
+        }
+
+        // 落后时只有下一帧是关键帧才能跳过本帧（差分帧依赖上一帧的画面）
+        skippable = (i + 1 < p->frame_count && anim_frame_meta(p, i + 1, &next_duration, &next_flags) == 0 &&
+                     (next_flags & ANIM_FRAME_KEY));
+
+        if (anim_pace_skip(&emotion_pace, duration, skippable)) {
+            continue;
+        }
+
+        if (streaming) {
+            // 取当前帧，同时让读取任务预读下一帧，SD卡读取与本帧解码发送重叠
+            next = (i + 1 < p->frame_count) ? i + 1 : ANIM_STREAM_NONE;
+            frame = anim_stream_frame(&emotion_stream, index, next, &frame_size);
+        } else {
+            // 动画包常驻地址空间（预读缓存、Flash映射或固件内置），帧数据直接交给解码器，无需拷贝
+            frame = (anim_frame_info(p, index, &offset, &frame_size) == 0) ? p->base + offset : NULL;
+        }
+
+        if (i == 0 && fade && frame != NULL && emotion_shadow_ok && emotion_shadow_fresh &&
+            (frame_flags & ANIM_FRAME_KEY)) {
+            emotion_crossfade(p, frame, frame_size);
+        }
+
+        // 差分帧依赖上一帧已经画到屏幕上，因此不能因抢不到LCD而跳帧，等待时间计入排期
+        xSemaphoreTake(lcd_mutex, portMAX_DELAY);
+        lcd_draw_frame(p, frame, frame_size);
+        xSemaphoreGive(lcd_mutex);  // 释放控制权
+
+        if (emotion_shadow_ok && (frame_flags & ANIM_FRAME_KEY)) {
+            emotion_shadow_fresh = true;
+        }
+
+        anim_pace_advance(&emotion_pace, duration);
+        emotion_sleep();
+    }
+
+    anim_cache_put(cached);
+}
+
+// 预读一个表情接下来要用到的序列（后台读取，序列开始时直接从内存解码）
+static void emotion_prefetch_seq(uint8_t id, bool in)
+{
+    const emotion_desc_t *desc;
+
+    if (id == EMOTION_NONE || id >= EMOTION_COUNT) {
+        return;
+    }
+
+    desc = &emotion_table[id];
+
+    if (in && desc->in != NULL) {
+        anim_cache_prefetch(desc->in);
+    }
+
+    if (desc->loop != NULL) {
+        anim_cache_prefetch(desc->loop);
+    }
+
+    if (!in && desc->out != NULL) {
+        anim_cache_prefetch(desc->out);
+    }
+}
+
+// 打印本次动画的帧节奏统计
+static void emotion_print_stats(void)
+{
+    anim_cache_stats_t cache;
+    lcd_mem_stats_t mem;
+
+    anim_cache_get_stats(&cache);
+    lcd_mem_get_stats(&mem);
+    printf("动画统计: 显示%lu帧, 超时%lu帧, 丢弃%lu帧, 重新排期%lu次, 最大落后%ldus\n",
+           (unsigned long)emotion_pace.frames, (unsigned long)emotion_pace.late,
+           (unsigned long)emotion_pace.dropped, (unsigned long)emotion_pace.resync,
+           (long)emotion_pace.max_lag_us);
+    printf("预读缓存: 命中%lu次, 未命中%lu次, 读入%lu个, 淘汰%lu个, 占用%lu/%lu字节\n",
+           (unsigned long)cache.hits, (unsigned long)cache.misses, (unsigned long)cache.loads,
+           (unsigned long)cache.evictions, (unsigned long)cache.used, (unsigned long)ANIM_CACHE_BUDGET);
+    printf("显示缓存: 内部RAM%lu字节(含SD卡动画包流), 预读缓存最多%lu字节, 比原来的整屏缓存净节省%ld字节\n",
+           (unsigned long)mem.internal, (unsigned long)mem.reserved, (long)mem.saved);
+}
+
+// 获取当前（或最近一次）动画的帧节奏统计
+void emotion_get_stats(anim_pace_t *stats)
+{
+    *stats = emotion_pace;
+}
+
+// 按描述表播放一个表情：入场→循环（直到请求切换）→退场
+// 切换到其他表情且描述表允许时跳过退场，由下一个表情的首帧从当前画面交叉淡入
+static void emotion_run(uint8_t id)
+{
+    const emotion_desc_t *desc = &emotion_table[id];
+    bool wrap = false;
+    bool fade = emotion_xfade;
+    uint8_t hint = emotion_hint;
+
+    emotion_current = id;
+    anim_pace_start_clock(&emotion_pace, emotion_clock);
+    emotion_xfade = false;
+    emotion_stream_absent = NULL;   // 每个表情重新查找一次SD卡（期间可能换过卡）
+    printf("播放%s表情\n", desc->name);
+
+    // 播放入场序列时预读本表情的循环/退场序列，以及下一首曲目的表情（见emotion_prefetch）
+    emotion_prefetch_seq(id, false);
+
+    if (hint != id) {
+        emotion_prefetch_seq(hint, true);
+    }
+
+    // 1. 入场序列：播完才进入循环，只有快速切换才打断
+    if (desc->in != NULL) {
+        play_expression(desc->in, false, EMOTION_LEAVE_FAST, 0, fade);
+        fade = false;
+    }
+
+    // 2. 循环序列：每帧之间检查切换请求，首轮之后用回环差分帧衔接，节奏随音乐响度变化
+    while (!emotion_leave(EMOTION_LEAVE_SWITCH)) {
+        play_expression(desc->loop, wrap, EMOTION_LEAVE_SWITCH, desc->react_pct, fade);
+        wrap = true;
+        fade = false;
+
+        if (desc->loop_pause_ms && !emotion_leave(EMOTION_LEAVE_SWITCH)) {
+            anim_pace_hold(&emotion_pace, desc->loop_pause_ms);
+            emotion_sleep();
+        }
+    }
+
+    // 3. 退场序列：停止时总是播放；切换到其他表情时按描述表决定，快速切换时随时中断
+    if (emotion_request != EMOTION_NONE && (desc->flags & EMOTION_FLAG_XFADE) && emotion_shadow_fresh) {
+        emotion_xfade = true;
+    } else if (emotion_request == EMOTION_NONE || (desc->flags & EMOTION_FLAG_OUT_ON_SWITCH)) {
+        play_expression(desc->out, false, EMOTION_LEAVE_FAST, 0, false);
+    }
+
+    emotion_print_stats();         // 在关闭动画包流之前统计，包括其占用的内存
+    emotion_stream_close();
+    emotion_current = EMOTION_NONE;
+}
+
+// 表情播放任务：常驻，空闲时阻塞在命令队列上，一个任务可以播放任意表情
+static void emotion_player_task(void *param)
+{
+    emotion_cmd_t cmd;
+
+    param = param;
+
+    while (1) {
+        if (emotion_request == EMOTION_NONE || emotion_request >= EMOTION_COUNT) {
+            if (xQueueReceive(emotion_queue, &cmd, portMAX_DELAY) == pdTRUE) {
+                emotion_apply(&cmd);
             }
-            vTaskDelay(pdMS_TO_TICKS(10));
+            continue;
         }
-        // 若超时未退出，强制删除任务（避免资源泄漏）
-        if (emotion_task_handle != NULL) {
-            vTaskDelete(emotion_task_handle);
-            emotion_task_handle = NULL;
-            printf("强制删除旧动画任务\n");
+
+        emotion_run(emotion_request);
+    }
+}
+
+// 创建命令队列和播放任务（在lcd_mutex创建之后调用一次）
+void emotion_init(void)
+{
+    if (emotion_queue != NULL) {
+        return;
+    }
+
+    emotion_queue = xQueueCreate(EMOTION_QUEUE_LEN, sizeof(emotion_cmd_t));
+
+    if (emotion_queue == NULL) {
+        printf("动画命令队列创建失败\n");
+        return;
+    }
+
+    if (anim_cache_init() != 0) {
+        printf("动画预读缓存初始化失败\n");
+    }
+
+    if (lcd_anim_init() != 0) {         // 提前申请绘制缓存，计入启动时的显示缓存报告
+        printf("动画绘制缓存内存不足\n");
+    }
+
+#if CONFIG_EMOTION_XFADE_SHADOW
+    // 影子帧只在menuconfig中开启时申请（默认只在有PSRAM时开启），否则表情切换时直接切到新画面
+    emotion_shadow = lcd_mem_alloc(LCD_MEM_FRAME, FRAME_WIDTH * FRAME_HEIGHT * 2, "emotion_shadow");
+
+    if (emotion_shadow == NULL) {
+        printf("影子帧内存不足，表情切换不做淡入淡出\n");
+    }
+#endif
+
+    xTaskCreate(emotion_player_task, "emotion", EMOTION_TASK_STK_SIZE, NULL,
+                EMOTION_TASK_PRIO, &emotion_task_handle);
+}
+
+// 向播放任务发送命令，并等待应答
+// 播放任务在帧之间都阻塞在命令队列上，命令通常在当前帧绘制完之前就被接收
+// 返回值: 0,已接收; 1,未初始化或队列已满; 2,应答超时（命令仍会被执行）
+static uint8_t emotion_send(uint8_t cmd, uint8_t id, uint16_t bpm)
+{
+    static uint32_t seq = 0;
+    emotion_cmd_t c;
+    uint32_t value;
+    TickType_t start = xTaskGetTickCount();
+    TickType_t timeout = pdMS_TO_TICKS(EMOTION_ACK_TIMEOUT_MS);
+    TickType_t elapsed;
+
+    if (emotion_queue == NULL) {
+        return 1;
+    }
+
+    taskENTER_CRITICAL(&emotion_spinlock);
+    c.seq = ++seq;
+    taskEXIT_CRITICAL(&emotion_spinlock);
+    c.cmd = cmd;
+    c.id = id;
+    c.bpm = bpm;
+    c.sender = xTaskGetCurrentTaskHandle();
+
+    if (xQueueSend(emotion_queue, &c, 0) != pdTRUE) {
+        printf("动画命令队列已满\n");
+        return 1;
+    }
+
+    // 之前超时的命令可能迟到应答，按序号分辨
+    while ((elapsed = xTaskGetTickCount() - start) <= timeout) {
+        if (xTaskNotifyWait(0, 0, &value, timeout - elapsed) == pdTRUE && value == c.seq) {
+            return 0;
         }
     }
-}
\ No newline at end of file
+
+    printf("动画命令应答超时\n");
+    return 2;
+}
+
+// 请求播放表情
+// id: 表情编号，EMOTION_NONE表示停止
+// fast: true时不等待当前表情的入场/退场序列播完，在下一帧之前就切换
+void emotion_play(emotion_id_t id, bool fast)
+{
+    if (id == EMOTION_NONE) {
+        emotion_send(EMOTION_CMD_STOP, EMOTION_NONE, 0);
+    } else {
+        emotion_send(fast ? EMOTION_CMD_SWITCH : EMOTION_CMD_PLAY, id, 0);
+    }
+}
+
+// 开始播放曲目时切换到曲目标注的表情（见track_meta），循环序列跟随曲目节拍
+// id: 表情编号，EMOTION_NONE表示停止; bpm: 曲目节拍，0表示未知
+void emotion_play_track(emotion_id_t id, uint16_t bpm)
+{
+    if (id == EMOTION_NONE) {
+        emotion_send(EMOTION_CMD_STOP, EMOTION_NONE, 0);
+    } else {
+        emotion_send(EMOTION_CMD_SWITCH, id, bpm);
+    }
+}
+
+// 提示接下来可能播放的表情（如下一首曲目标注的表情），播放下一个表情时在后台预读它的入场/循环序列
+void emotion_prefetch(emotion_id_t id)
+{
+    emotion_hint = (id < EMOTION_COUNT) ? id : EMOTION_NONE;
+}
+
+// 按名字查找表情（不区分大小写），name不必以'\0'结尾
+// 返回值: 表情编号，EMOTION_NONE表示没有该表情
+emotion_id_t emotion_find(const char *name, size_t len)
+{
+    for (int i = EMOTION_NONE + 1; i < EMOTION_COUNT; i++) {
+        if (emotion_table[i].name != NULL && strlen(emotion_table[i].name) == len &&
+            strncasecmp(emotion_table[i].name, name, len) == 0) {
+            return (emotion_id_t)i;
+        }
+    }
+
+    return EMOTION_NONE;
+}
+
+// 启动开心动画（切歌时立即切换，不等旧表情退场）
+void play_happy_emotion(void)
+{
+    emotion_play(EMOTION_HAPPY, true);
+}
+
+// 启动难过动画（切歌时立即切换，不等旧表情退场）
+void play_sad_emotion(void)
+{
+    emotion_play(EMOTION_SAD, true);
+}
+
+// 停止动画：播放任务退出循环并播完退场序列后回到空闲
+// 只是向常驻的播放任务发送命令，不会删除任务，也不会在任务持有lcd_mutex时打断它
+void stop_emotion_task(void) {
+    emotion_play(EMOTION_NONE, false);
+}
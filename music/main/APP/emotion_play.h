@@ -1,26 +1,96 @@
 #ifndef __EMOTION_PLAY_H__
 #define __EMOTION_PLAY_H__
 
-#include "excited_in_frames.h"
-#include "excited_loop_frames.h"
-#include "excited_out_frames.h"
-#include "sad_in_frames.h"
-#include "sad_loop_frames.h"
-#include "sad_out_frames.h"
+#include "emotion_frames.h"
+#include "anim.h"
+#include "anim_stream.h"
+#include "anim_flash.h"
+#include "anim_cache.h"
+#include "anim_pace.h"
+#include "anim_blit.h"
+#include "audio_meter.h"
 #include "lcd.h"
+#include "lcd_anim.h"
+#include "esp_attr.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/queue.h"
+
+#define EMOTION_TASK_PRIO       3           // 播放任务优先级（低于音频任务）
+#define EMOTION_TASK_STK_SIZE   8192        // 播放任务堆栈大小
+#define EMOTION_QUEUE_LEN       4           // 命令队列长度
+#define EMOTION_ACK_TIMEOUT_MS  50          // 等待播放任务应答的最长时间
+#define EMOTION_REACT_FULL      12000       // 达到该RMS电平（满幅32767）时循环序列加速到最快
+#define EMOTION_BLIT_MODE       ANIM_BLIT_INTEGER   // 动画帧到屏幕的缩放方式（ANIM_BLIT_xxx）
+#define EMOTION_XFADE_MS        240         // 表情切换时交叉淡入淡出的时长
+#define EMOTION_XFADE_STEPS     6           // 交叉淡入淡出的步数（最后一步即完整的首帧）
+#define EMOTION_TEMPO_REF       120         // 循环序列按此节拍（拍/分钟）制作
+#define EMOTION_TEMPO_MIN_PCT   50          // 跟随节拍时帧时长的最小比例
+#define EMOTION_TEMPO_MAX_PCT   200         // 跟随节拍时帧时长的最大比例
+
+// 播放命令
+#define EMOTION_CMD_PLAY        0           // 播放表情，当前表情按描述表正常退场
+#define EMOTION_CMD_STOP        1           // 停止，当前表情播完退场序列后空闲
+#define EMOTION_CMD_SWITCH      2           // 快速切换，当前表情在下一帧之前结束
+
+// 表情编号（emotion_play.c 中的描述表按此编号索引）
+typedef enum {
+    EMOTION_NONE = 0,                       // 无表情（停止）
+    EMOTION_HAPPY,                          // 开心
+    EMOTION_SAD,                            // 难过
+    EMOTION_COUNT
+} emotion_id_t;
+
+// 描述表标志
+#define EMOTION_FLAG_OUT_ON_SWITCH  0x01    // 切换到其他表情时也播放退场序列（快速切换除外）
+#define EMOTION_FLAG_XFADE          0x02    // 切换到其他表情时不播放退场序列，直接交叉淡入下一个表情（优先于OUT_ON_SWITCH）
+
+// 表情描述：入场/循环/退场三段动画包名（NULL表示没有该段）及时序
+typedef struct {
+    const char *name;                       // 表情名（用于打印）
+    const char *in;                         // 入场序列，播放一次
+    const char *loop;                       // 循环序列，重复播放直到切换
+    const char *out;                        // 退场序列，播放一次
+    uint16_t loop_pause_ms;                 // 每轮循环之间停留的时间
+    uint8_t react_pct;                      // 循环序列随音乐响度加速的最大百分比（0表示不随音乐变化）
+    uint8_t flags;                          // EMOTION_FLAG_xxx
+} emotion_desc_t;
+
+// 序列中途退出的条件
+typedef enum {
+    EMOTION_LEAVE_SWITCH,                   // 请求了其他表情即退出
+    EMOTION_LEAVE_FAST                      // 只有快速切换才退出
+} emotion_leave_t;
 
 // 动画播放任务句柄
 extern TaskHandle_t emotion_task_handle;
 extern SemaphoreHandle_t lcd_mutex;
+
+// 创建命令队列和常驻播放任务
+void emotion_init(void);
+
+// 请求播放表情，EMOTION_NONE表示停止；fast为true时不等待入场/退场序列播完
+void emotion_play(emotion_id_t id, bool fast);
+
 // 播放开心表情动画
 void play_happy_emotion(void);
 
 // 播放难过表情动画
 void play_sad_emotion(void);
 
+// 开始播放曲目时切换到曲目标注的表情，循环序列跟随曲目节拍（bpm为0表示未知）
+void emotion_play_track(emotion_id_t id, uint16_t bpm);
+
+// 提示接下来可能播放的表情，播放下一个表情时在后台预读它的入场/循环序列
+void emotion_prefetch(emotion_id_t id);
+
+// 按名字查找表情（不区分大小写），未找到返回EMOTION_NONE
+emotion_id_t emotion_find(const char *name, size_t len);
+
 // 停止动画播放
 void stop_emotion_task(void);
 
+// 获取帧节奏统计（已显示/超时/丢弃帧数），用于按实际SPI吞吐调整动画
+void emotion_get_stats(anim_pace_t *stats);
+
 #endif
\ No newline at end of file
@@ -30,7 +30,7 @@
  *   @note      sizeС,ݴСΪ: (size / 8 + ((size % 8) ? 1 : 0)) * (size)  ֽ
  * @retval      
  */
-static void text_get_hz_mat(unsigned char *code, unsigned char *mat, uint8_t size)
+void text_get_hz_mat(unsigned char *code, unsigned char *mat, uint8_t size)
 {
     unsigned char qh, ql;
     unsigned char i;
@@ -33,6 +33,7 @@
 
 
 /*  */
+void text_get_hz_mat(unsigned char *code, unsigned char *mat, uint8_t size);                                                             /* ȡֵ */
 void text_show_font(uint16_t x, uint16_t y, uint8_t *font, uint8_t size, uint8_t mode, uint32_t color);                                 /* ʾ */
 void text_show_string(uint16_t x, uint16_t y, uint16_t width, uint16_t height, char *str, uint8_t size, uint8_t mode, uint32_t color);  /* ʾַ */
 void text_show_string_middle(uint16_t x, uint16_t y, char *str, uint8_t size, uint16_t width, uint32_t color);                          /* ʾַ */
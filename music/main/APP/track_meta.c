@@ -0,0 +1,311 @@
+/**
+ ****************************************************************************************************
+ * @file        track_meta.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       曲目元数据 代码
+ ****************************************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "track_meta.h"
+#include "emotion_play.h"
+
+
+#define TRACK_META_ID(a, b, c, d)   ((uint32_t)(a) | ((uint32_t)(b) << 8) | ((uint32_t)(c) << 16) | ((uint32_t)(d) << 24))
+
+/**
+ * @brief       读取小端32位数据
+ * @param       p : 数据地址
+ * @retval      读出的值
+ */
+static uint32_t track_meta_rd32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief       判断是否为分隔符
+ * @param       ch : 字符
+ * @retval      1,是;0,否
+ */
+static uint8_t track_meta_is_sep(char ch)
+{
+    return ch == ' ' || ch == '\t' || ch == ',' || ch == ';' || ch == '\r' || ch == '\n' || ch == '\0';
+}
+
+/**
+ * @brief       解析元数据文本
+ * @note        只识别 emotion=<表情名> 和 bpm=<数字> 两项,其他内容忽略;文本不必以'\0'结尾
+ * @param       text : 文本
+ * @param       len  : 文本长度
+ * @param       meta : 解析出的项写入此处,未出现的项保持不变
+ * @retval      无
+ */
+void track_meta_parse(const char *text, uint32_t len, track_meta_t *meta)
+{
+    const char *end = text + len;
+    const char *key;
+    const char *val;
+    const char *digits;
+    uint32_t key_len;
+    uint32_t val_len;
+    uint32_t bpm;
+    uint8_t id;
+
+    while (text < end)
+    {
+        while (text < end && track_meta_is_sep(*text))
+        {
+            text++;
+        }
+
+        key = text;
+
+        while (text < end && !track_meta_is_sep(*text) && *text != '=')
+        {
+            text++;
+        }
+
+        key_len = text - key;
+
+        if (text >= end || *text != '=')
+        {
+            continue;                                           /* 不是 key=value 形式 */
+        }
+
+        val = ++text;
+
+        while (text < end && !track_meta_is_sep(*text))
+        {
+            text++;
+        }
+
+        val_len = text - val;
+
+        if (key_len == 7 && strncasecmp(key, "emotion", 7) == 0)
+        {
+            id = emotion_find(val, val_len);
+
+            if (id != EMOTION_NONE || (val_len == 4 && strncasecmp(val, "none", 4) == 0))
+            {
+                meta->emotion = id;
+            }
+        }
+        else if (key_len == 3 && strncasecmp(key, "bpm", 3) == 0)
+        {
+            digits = val;
+
+            for (bpm = 0; val_len > 0 && *val >= '0' && *val <= '9' && bpm < 1000; val++, val_len--)
+            {
+                bpm = bpm * 10 + (*val - '0');
+            }
+
+            if (val != digits && bpm < 1000)                    /* 没有数字(如bpm=fast)时保持原值 */
+            {
+                meta->bpm = bpm;
+            }
+        }
+    }
+}
+
+/**
+ * @brief       读取WAV文件LIST/INFO块中的元数据
+ * @note        依次跳过各RIFF块查找LIST/INFO块(可以在data块之后),
+ *              解析其中的ICMT/IKEY/IGNR字段,只读取块头和INFO块内容
+ * @param       path : 文件路径+文件名
+ * @param       meta : 解析出的项写入此处
+ * @retval      0,找到LIST/INFO块
+ *              1,打开文件失败或内存不足
+ *              2,非WAV文件或没有LIST/INFO块
+ */
+uint8_t track_meta_read_wav(const char *path, track_meta_t *meta)
+{
+    FIL *file;
+    uint8_t *buf;
+    uint8_t head[12];
+    uint32_t pos = 12;
+    uint32_t id;
+    uint32_t chunk;
+    uint32_t size;
+    uint32_t n;
+    uint32_t i;
+    uint8_t res = 2;
+    UINT br = 0;
+
+    file = (FIL *)malloc(sizeof(FIL));
+    buf = malloc(TRACK_META_INFO_MAX);
+
+    if (file == NULL || buf == NULL || f_open(file, (const TCHAR *)path, FA_READ) != FR_OK)
+    {
+        free(file);
+        free(buf);
+        return 1;
+    }
+
+    if (f_read(file, head, 12, &br) != FR_OK || br != 12 ||
+        track_meta_rd32(head) != TRACK_META_ID('R', 'I', 'F', 'F') ||
+        track_meta_rd32(head + 8) != TRACK_META_ID('W', 'A', 'V', 'E'))
+    {
+        pos = 0;                                                /* 非WAV文件 */
+    }
+
+    for (i = 0; pos != 0 && i < TRACK_META_CHUNK_MAX && res != 0; i++)
+    {
+        if (f_lseek(file, pos) != FR_OK || f_read(file, head, 12, &br) != FR_OK || br < 8)
+        {
+            break;                                              /* 到文件末尾 */
+        }
+
+        id = track_meta_rd32(head);
+        chunk = track_meta_rd32(head + 4);
+
+        if (id == TRACK_META_ID('L', 'I', 'S', 'T') && br == 12 && chunk >= 4 &&
+            track_meta_rd32(head + 8) == TRACK_META_ID('I', 'N', 'F', 'O'))
+        {
+            n = (chunk - 4 > TRACK_META_INFO_MAX) ? TRACK_META_INFO_MAX : chunk - 4;
+
+            if (f_read(file, buf, n, &br) != FR_OK)
+            {
+                break;
+            }
+
+            for (n = 0; n + 8 <= br; n += 8 + size + (size & 1))   /* 各字段按偶数字节对齐 */
+            {
+                id = track_meta_rd32(buf + n);
+                size = track_meta_rd32(buf + n + 4);
+
+                if (size > br - n - 8)
+                {
+                    size = br - n - 8;                          /* 超出读取范围的部分不解析 */
+                }
+
+                if (id == TRACK_META_ID('I', 'C', 'M', 'T') || id == TRACK_META_ID('I', 'K', 'E', 'Y') ||
+                    id == TRACK_META_ID('I', 'G', 'N', 'R'))
+                {
+                    track_meta_parse((const char *)buf + n + 8, size, meta);
+                }
+            }
+
+            res = 0;
+        }
+
+        if (pos + 8 + chunk + (chunk & 1) <= pos)
+        {
+            break;                                              /* 块长度错误 */
+        }
+
+        pos += 8 + chunk + (chunk & 1);
+    }
+
+    f_close(file);
+    free(file);
+    free(buf);
+
+    return res;
+}
+
+/**
+ * @brief       读入曲库目录下的元数据文件
+ * @param       dir : 曲库目录,如"0:/MUSIC"
+ * @retval      文件内容(以'\0'结尾,用完后free),NULL表示没有该文件或内存不足
+ */
+char *track_meta_load_sidecar(const char *dir)
+{
+    char path[48];
+    FIL *file;
+    char *text = NULL;
+    UINT br = 0;
+
+    snprintf(path, sizeof(path), "%s/%s", dir, TRACK_META_SIDECAR);
+    file = (FIL *)malloc(sizeof(FIL));
+
+    if (file == NULL)
+    {
+        return NULL;
+    }
+
+    if (f_open(file, (const TCHAR *)path, FA_READ) == FR_OK)
+    {
+        text = malloc(TRACK_META_SIDECAR_MAX + 1);
+
+        if (text != NULL)
+        {
+            if (f_read(file, text, TRACK_META_SIDECAR_MAX, &br) == FR_OK)
+            {
+                text[br] = '\0';
+            }
+            else
+            {
+                free(text);
+                text = NULL;
+            }
+        }
+
+        f_close(file);
+    }
+
+    free(file);
+
+    return text;
+}
+
+/**
+ * @brief       在元数据文件中查找曲目
+ * @note        行首为文件名(不区分大小写,可以含空格),其后是空白和元数据文本
+ * @param       sidecar : 元数据文件内容
+ * @param       fname   : 文件名(不含路径)
+ * @param       meta    : 解析出的项写入此处
+ * @retval      0,找到;1,未找到
+ */
+uint8_t track_meta_sidecar_find(const char *sidecar, const char *fname, track_meta_t *meta)
+{
+    const char *line = sidecar;
+    const char *end;
+    size_t len = strlen(fname);
+
+    while (line != NULL && *line != '\0')
+    {
+        end = strchr(line, '\n');
+
+        if (end == NULL)
+        {
+            end = line + strlen(line);
+        }
+
+        if ((size_t)(end - line) > len && strncasecmp(line, fname, len) == 0 &&
+            (line[len] == ' ' || line[len] == '\t'))
+        {
+            track_meta_parse(line + len, end - line - len, meta);
+            return 0;
+        }
+
+        line = (*end == '\n') ? end + 1 : end;
+    }
+
+    return 1;
+}
+
+/**
+ * @brief       取得一首曲目的元数据
+ * @param       path    : 文件路径+文件名
+ * @param       fname   : 文件名(不含路径)
+ * @param       sidecar : 元数据文件内容,NULL表示没有
+ * @param       meta    : 元数据
+ * @retval      无
+ */
+void track_meta_get(const char *path, const char *fname, const char *sidecar, track_meta_t *meta)
+{
+    meta->emotion = EMOTION_NONE;
+    meta->bpm = 0;
+
+    track_meta_read_wav(path, meta);
+
+    if (sidecar != NULL)
+    {
+        track_meta_sidecar_find(sidecar, fname, meta);
+    }
+}
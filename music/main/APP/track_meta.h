@@ -0,0 +1,41 @@
+/**
+ ****************************************************************************************************
+ * @file        track_meta.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       曲目元数据 代码
+ *              曲目的表情和节拍写成"emotion=happy bpm=128"形式的文本(空格/逗号/分号分隔,不区分大小写),
+ *              来源有两处,后者优先:
+ *              1. WAV文件的LIST/INFO块中的ICMT(注释)/IKEY(关键词)/IGNR(流派)字段
+ *              2. 曲库目录下的TRACKS.TXT,每行为"文件名 emotion=happy bpm=128"
+ *              audio_play()建立曲库索引时逐个解析,之后按曲目序号直接取用,开始播放时不再读取或查找
+ ****************************************************************************************************
+ */
+
+#ifndef __TRACK_META_H
+#define __TRACK_META_H
+
+#include <stdint.h>
+#include "ff.h"
+
+
+#define TRACK_META_SIDECAR      "TRACKS.TXT"    /* 曲库目录下的元数据文件名 */
+#define TRACK_META_SIDECAR_MAX  4096        /* 元数据文件最多读取的字节数 */
+#define TRACK_META_INFO_MAX     512         /* LIST/INFO块最多读取的字节数 */
+#define TRACK_META_CHUNK_MAX    16          /* 查找LIST块时最多检查的RIFF块数 */
+
+/* 曲目元数据 */
+typedef struct
+{
+    uint8_t emotion;                        /* 表情编号(emotion_id_t),EMOTION_NONE表示不播放动画 */
+    uint16_t bpm;                           /* 节拍(每分钟拍数),0表示未知 */
+} track_meta_t;
+
+/* 函数声明 */
+void track_meta_parse(const char *text, uint32_t len, track_meta_t *meta);     /* 解析元数据文本 */
+uint8_t track_meta_read_wav(const char *path, track_meta_t *meta);              /* 读取WAV文件LIST/INFO块中的元数据 */
+char *track_meta_load_sidecar(const char *dir);                                 /* 读入曲库目录下的元数据文件 */
+uint8_t track_meta_sidecar_find(const char *sidecar, const char *fname, track_meta_t *meta);    /* 在元数据文件中查找曲目 */
+void track_meta_get(const char *path, const char *fname, const char *sidecar, track_meta_t *meta);  /* 取得一首曲目的元数据 */
+
+#endif
@@ -23,6 +23,8 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "emotion_play.h"
+#include "esp_timer.h"
+#include "audio_meter.h"
 /******************************************************************************************************/
 /*FreeRTOS配置*/
 
@@ -44,6 +46,94 @@ __wavctrl wavctrl;                          /* WAV控制结构体 */
 esp_err_t i2s_play_end = ESP_FAIL;
 esp_err_t i2s_play_next_prev = ESP_FAIL;
 
+/* 播放时钟:由I2S实际接收的数据量推算当前播放到的采样位置 */
+static portMUX_TYPE wav_clock_spinlock = portMUX_INITIALIZER_UNLOCKED;
+static uint64_t wav_clock_frames = 0;       /* 本曲已写入I2S的采样帧数 */
+static int64_t wav_clock_time = 0;          /* 最近一次写入完成的时刻(us) */
+static int64_t wav_clock_last = 0;          /* 上次返回的播放位置(us),保证时钟不倒退 */
+
+/**
+ * @brief       播放时钟归零(开始新的一曲)
+ * @param       无
+ * @retval      无
+ */
+static void wav_clock_reset(void)
+{
+    taskENTER_CRITICAL(&wav_clock_spinlock);
+    wav_clock_frames = 0;
+    wav_clock_time = esp_timer_get_time();
+    wav_clock_last = 0;
+    taskEXIT_CRITICAL(&wav_clock_spinlock);
+}
+
+/**
+ * @brief       记录写入I2S的数据量
+ * @param       bytes : i2s_tx_write()实际写入的字节数
+ * @retval      无
+ */
+static void wav_clock_add(uint32_t bytes)
+{
+    int64_t now = esp_timer_get_time();
+
+    if (wavctrl.blockalign == 0)
+    {
+        return;
+    }
+
+    taskENTER_CRITICAL(&wav_clock_spinlock);
+    wav_clock_frames += bytes / wavctrl.blockalign;
+    wav_clock_time = now;
+    taskEXIT_CRITICAL(&wav_clock_spinlock);
+}
+
+/**
+ * @brief       获取当前曲目的播放位置
+ * @note        i2s_tx_write()返回时I2S的DMA缓存刚被写满,此时实际播放到 已写入帧数 - DMA缓存帧数,
+ *              之后按采样率推进,但不会超过已写入的帧数(读SD卡卡顿造成断音时时钟随之停走)
+ * @param       us : 播放位置(us)
+ * @retval      0,正在播放;1,未在播放(暂停或停止),us无效
+ */
+uint8_t wav_get_clock(int64_t *us)
+{
+    int64_t now = esp_timer_get_time();
+    int64_t frames;
+    int64_t played;
+    uint32_t rate = wavctrl.samplerate;
+
+    if ((g_audiodev.status & 0x0F) != 0x03 || rate == 0)
+    {
+        return 1;
+    }
+
+    taskENTER_CRITICAL(&wav_clock_spinlock);
+    frames = (int64_t)wav_clock_frames;
+    played = frames - WAV_I2S_QUEUED_FRAMES + (now - wav_clock_time) * rate / 1000000;
+
+    if (played > frames)
+    {
+        played = frames;
+    }
+
+    if (played < 0)
+    {
+        played = 0;
+    }
+
+    played = played * 1000000 / rate;
+
+    if (played < wav_clock_last)
+    {
+        played = wav_clock_last;
+    }
+
+    wav_clock_last = played;
+    taskEXIT_CRITICAL(&wav_clock_spinlock);
+
+    *us = played;
+
+    return 0;
+}
+
 /**
  * @brief       WAV解析初始化
  * @param       fname : 文件路径+文件名
@@ -186,14 +276,16 @@ void music(void *pvParameters)
                     i2s_table_size = 0;
                     i2s_play_end = ESP_OK;
                     audio_stop();
-                    printf("WAV文件解析失败，停止动画\n");
-                    stop_emotion_task(); // 音频结束，停止动画
+                    audio_meter_reset();                                    /* 动画不在这里停止,由下一曲的wav_play_song()切换,以便交叉淡入 */
                     vTaskDelay(10);
                     break;
                 }
 
                 f_read(g_audiodev.file,g_audiodev.tbuf, WAV_TX_BUFSIZE, (UINT*)&nr);        /* 读文件 */
-                i2s_table_size = i2s_table_size + i2s_tx_write(g_audiodev.tbuf, WAV_TX_BUFSIZE);
+                audio_meter_process(g_audiodev.tbuf, nr, wavctrl.bps, wavctrl.nchannels, wavctrl.samplerate);   /* 电平分析,供动画使用 */
+                nr = i2s_tx_write(g_audiodev.tbuf, WAV_TX_BUFSIZE);
+                wav_clock_add(nr);
+                i2s_table_size = i2s_table_size + nr;
                 vTaskDelay(1);
             }
 
@@ -208,11 +300,12 @@ void music(void *pvParameters)
 /**
  * @brief       播放某个wav文件
  * @param       fname : 文件路径+文件名
+ * @param       meta  : 曲目元数据(见track_meta.h),NULL表示没有
  * @retval      KEY0_PRES,错误
  *              KEY1_PRES,打开文件失败
  *              其他,非WAV文件
  */
-uint8_t wav_play_song(uint8_t *fname)
+uint8_t wav_play_song(uint8_t *fname, const track_meta_t *meta)
 {
     uint8_t key = 0;
     uint8_t t = 0;
@@ -221,7 +314,6 @@ uint8_t wav_play_song(uint8_t *fname)
     i2s_play_next_prev = ESP_FAIL;
     g_audiodev.file = (FIL*)malloc(sizeof(FIL));
     g_audiodev.tbuf = malloc(WAV_TX_BUFSIZE);
-    stop_emotion_task();
     printf("准备播放文件：%s\n", fname);
 
     if (g_audiodev.file || g_audiodev.tbuf)
@@ -230,17 +322,20 @@ uint8_t wav_play_song(uint8_t *fname)
 
         if (res == 0)                                                           /* 解析文件成功 */
         {
-                // 根据文件名判断动画类型（核心逻辑）
-            if (strstr((char*)fname, "1")) {
-                printf("触发开心动画\n");
-                play_happy_emotion();  // 1.wav → 开心动画
-            } else if (strstr((char*)fname, "2")) {
-                 printf("触发难过动画\n");
-                play_sad_emotion();    // 2.wav → 难过动画
-            } else {
-                 printf("未识别文件，不播放动画\n");
-                stop_emotion_task();   // 其他文件 → 停止动画
+            wav_clock_reset();                                                  /* 播放时钟从本曲开头计 */
+            audio_meter_reset();                                                /* 清除上一曲的电平 */
+            if (meta != NULL && meta->emotion != EMOTION_NONE)                 /* 按曲库索引中的元数据选择动画 */
+            {
+                printf("曲目表情%d, 节拍%d BPM\n", meta->emotion, meta->bpm);
             }
+            else
+            {
+                printf("曲目未标注表情，不播放动画（见MUSIC/%s）\n", TRACK_META_SIDECAR);
+            }
+
+            /* 每曲只向动画任务发一条命令(每条都要等应答):有表情时切换,否则停止 */
+            emotion_play_track((meta != NULL) ? (emotion_id_t)meta->emotion : EMOTION_NONE, (meta != NULL) ? meta->bpm : 0);
+
             if (wavctrl.bps == 16)
             {
                 es8388_sai_cfg(0, 3);                                           /* 飞利浦标准,16位数据长度 */
@@ -349,6 +444,7 @@ uint8_t wav_play_song(uint8_t *fname)
         }
         else
         {
+            emotion_play_track(EMOTION_NONE, 0);                                /* 无法播放,停止动画 */
             res = 0xFF;
         }
     }
@@ -29,9 +29,11 @@
 #include "driver/i2s_std.h"
 #include "led.h"
 #include "i2s.h"
+#include "track_meta.h"
 
 
 #define WAV_TX_BUFSIZE    8192  /* 定义WAV TX DMA 数组大小(播放192Kbps@24bit的时候,需要设置8192大才不会卡) */
+#define WAV_I2S_QUEUED_FRAMES   (8 * 256)   /* I2S DMA缓存的采样帧数(dma_buf_count * dma_buf_len,见i2s.c) */
 
 typedef struct
 {
@@ -108,7 +110,8 @@ typedef struct
 
 
 uint8_t wav_decode_init(uint8_t *fname, __wavctrl *wavx);           /* WAV解析初始化 */
-uint8_t wav_play_song(uint8_t *fname);                              /* 播放某个WAV文件 */
+uint8_t wav_play_song(uint8_t *fname, const track_meta_t *meta);   /* 播放某个WAV文件 */
+uint8_t wav_get_clock(int64_t *us);                                 /* 获取当前曲目的播放位置 */
 void wavplay_i2s_init(int samplerate,int bits_sample);
 size_t i2s_tx_write(uint8_t *buffer, uint32_t frame_size);
 #endif
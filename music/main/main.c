@@ -35,6 +35,7 @@
 #include "text.h"
 #include "i2s.h"
 #include "emotion_play.h"
+#include "compose.h"
 
 i2c_obj_t i2c0_master;
 
@@ -80,6 +81,13 @@ void app_main(void)
     i2s_init();                                         /* I2Sʼ */
     
     lcd_mutex = xSemaphoreCreateMutex();  // ʼLCD
+    if (compose_init() != 0)                            /* ʼֵӲ */
+    {
+        printf("ֵӲڴ治㣬Ϊֱʾ\n");
+    }
+
+    emotion_init();                                     /*  */
+    lcd_mem_report();                                   /* ӡʾķֲ */
 
     xTaskCreate(heartbeat_task, "heartbeat", 2048, NULL, 1, NULL);
 
@@ -0,0 +1,834 @@
+/**
+ ****************************************************************************************************
+ * @file        anim_bench.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       动画播放主机端基准测试
+ *              在PC上用与板上相同的帧绘制(lcd_anim.c)、解码器(anim.c/anim_blit.c)、画面合成(compose.c)
+ *              和LCD驱动(lcd.c)播放动画包,SPI由LCD模拟器(lcd_sim.c)代替,
+ *              统计每帧的发送字节数、SPI传输次数、窗口设置次数和解码耗时,可选把每帧画面保存为PPM图片;
+ *              播放时叠加文字层并维护影子帧,核对模拟显存、影子帧与参考解码结果是否一致,
+ *              播放后清空文字核对叠加层保存的背景,再以首帧做一步交叉淡入淡出核对混合结果;
+ *              开头先报告常用LCD绘图函数(播放界面的填充/文字等)的SPI传输量
+ *
+ *              用法: anim_bench [-m center|integer|fit|stretch] [-n 次数] [-p 目录] [-B 字节] [-T 次数] 动画包.anm...
+ *                -m : 缩放方式,默认integer(与EMOTION_BLIT_MODE相同)
+ *                -n : 计算解码耗时时重复解码的次数,默认20
+ *                -p : 把每帧画面保存为 <目录>/<包名>_<帧号>.ppm
+ *                -B : 平均每帧发送字节数超过该值时返回失败
+ *                -T : 平均每帧SPI传输次数超过该值时返回失败
+ ****************************************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "lcd.h"
+#include "lcd_anim.h"
+#include "anim.h"
+#include "anim_blit.h"
+#include "compose.h"
+#include "text.h"
+#include "emotion_play.h"
+#include "lcd_sim.h"
+
+
+#define BENCH_SPI_HZ            60000000    /* LCD的SPI时钟(见lcd_init) */
+#define BENCH_SCREEN_PIXELS     (320 * 240) /* 横屏画面的像素数 */
+#define BENCH_XFADE_ALPHA       (ANIM_BLEND_MAX / 2)            /* 交叉淡入淡出核对时新画面的权重 */
+
+SemaphoreHandle_t lcd_mutex = NULL;                             /* compose.c使用,主机端单线程 */
+
+static uint16_t bench_pixels[LCD_ANIM_CHUNK_PIXELS];            /* 纯解码耗时测试的输出 */
+static lcd_anim_t bench_anim = { .alpha = ANIM_BLEND_MAX, .overlay = compose_apply };
+static uint16_t bench_screen[BENCH_SCREEN_PIXELS];             /* 界面画面,用于比较直接绘图和帧缓存绘图的结果 */
+
+/* 播放时叠加的文字(与播放界面相同的位置和颜色,见compose.c) */
+static const char *bench_texts[COMPOSE_LAYERS] = {
+    [COMPOSE_TITLE]   = "01 - Track.wav",
+    [COMPOSE_TIME]    = "01:23/04:56",
+    [COMPOSE_BITRATE] = "1411Kbps",
+    [COMPOSE_INDEX]   = "1/12",
+};
+
+/**
+ * @brief       主机端替代:取得汉字点阵(没有字库,返回空白)
+ * @param       code : 汉字编码
+ * @param       mat  : 点阵数据
+ * @param       size : 字体大小
+ * @retval      无
+ */
+void text_get_hz_mat(unsigned char *code, unsigned char *mat, uint8_t size)
+{
+    (void)code;
+    memset(mat, 0, (size / 8 + ((size % 8) ? 1 : 0)) * size);
+}
+
+/**
+ * @brief       主机端替代:显示字符串(只显示ASCII)
+ * @param       x, y, width, height : 区域
+ * @param       str   : 字符串
+ * @param       size  : 字体大小
+ * @param       mode  : 叠加方式(未使用)
+ * @param       color : 文字颜色
+ * @retval      无
+ */
+void text_show_string(uint16_t x, uint16_t y, uint16_t width, uint16_t height, char *str, uint8_t size, uint8_t mode, uint32_t color)
+{
+    (void)mode;
+    lcd_show_string(x, y, width, height, size, str, color);
+}
+
+/**
+ * @brief       取得单调时钟(ns)
+ * @param       无
+ * @retval      时间
+ */
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * @brief       绘制一帧
+ * @note        与emotion_play.c的lcd_draw_frame()相同:lcd_anim_draw_frame()后重绘有变化的叠加层,等待发送完成
+ * @param       pack  : 动画包
+ * @param       index : 帧序号
+ * @retval      0,成功;1,帧数据错误
+ */
+static uint8_t bench_draw_frame(const anim_pack_t *pack, uint16_t index)
+{
+    uint32_t offset;
+    uint32_t size;
+    uint8_t res;
+
+    if (anim_frame_info(pack, index, &offset, &size) != 0)
+    {
+        return 1;
+    }
+
+    res = lcd_anim_draw_frame(&bench_anim, pack, pack->base + offset, size);
+    compose_update();
+    lcd_wait_data();
+
+    return res;
+}
+
+/**
+ * @brief       报告一次LCD绘图操作的SPI传输量
+ * @param       name : 操作名
+ * @retval      无
+ */
+static void bench_ui_report(const char *name)
+{
+    lcd_sim_stats_t st;
+
+    lcd_wait_data();
+    lcd_sim_get_stats(&st);
+    printf("%-26s %8lu trans %6lu polled %8lu bytes %5lu windows %8.0f spi_us\n", name, (unsigned long)st.transactions,
+           (unsigned long)(st.transactions - st.queued), (unsigned long)st.bytes, (unsigned long)st.windows,
+           st.bytes * 8.0 * 1000000 / BENCH_SPI_HZ);
+    lcd_sim_reset_stats();
+}
+
+/**
+ * @brief       报告显示缓存占用的内存
+ * @param       name : 场景名
+ * @retval      无
+ */
+static void bench_mem_report(const char *name)
+{
+    lcd_mem_stats_t st;
+
+    lcd_mem_get_stats(&st);
+    printf("%-26s %8lu internal %6lu psram %3d buffers %7ld saved\n", name, (unsigned long)st.internal,
+           (unsigned long)st.psram, st.count, (long)st.saved);
+}
+
+/**
+ * @brief       核对模拟显存中一个矩形区域的颜色
+ * @param       sx, sy, ex, ey : 矩形对角坐标
+ * @param       color          : 应有的颜色
+ * @retval      不一致的像素数
+ */
+static uint32_t bench_ui_check(uint16_t sx, uint16_t sy, uint16_t ex, uint16_t ey, uint16_t color)
+{
+    uint32_t bad = 0;
+    uint16_t x, y;
+
+    for (y = sy; y <= ey; y++)
+    {
+        for (x = sx; x <= ex; x++)
+        {
+            bad += (lcd_sim_pixel(x, y) != color);
+        }
+    }
+
+    return bad;
+}
+
+/**
+ * @brief       核对模拟显存中的一行文字(12/16号字体)
+ * @param       x, y  : 起点坐标
+ * @param       str   : 字符串
+ * @param       size  : 字体大小
+ * @param       color : 文字颜色
+ * @param       back  : 点阵中无效点应有的颜色
+ * @retval      不一致的像素数
+ */
+static uint32_t bench_ui_text(uint16_t x, uint16_t y, const char *str, uint8_t size, uint16_t color, uint16_t back)
+{
+    const uint8_t *glyph;
+    uint32_t bad = 0;
+    uint16_t r, c;
+
+    for (; *str; str++, x += size / 2)
+    {
+        glyph = lcd_ascii_glyph(*str, size);
+
+        for (r = 0; r < size; r++)
+        {
+            for (c = 0; c < size / 2; c++)
+            {
+                bad += (lcd_sim_pixel(x + c, y + r) != ((glyph[r] & (0x80 >> c)) ? color : back));
+            }
+        }
+    }
+
+    return bad;
+}
+
+/**
+ * @brief       画一个播放界面:进度条、边框、圆形按钮和文字
+ * @param       无
+ * @retval      无
+ */
+static void bench_ui_scene(void)
+{
+    lcd_draw_rectangle(28, 228, 291, 237, BLACK);               /* 进度条 */
+    lcd_fill(30, 230, 150, 235, GREEN);
+    lcd_draw_circle(300, 200, 12, BLUE);                        /* 播放按钮 */
+    lcd_draw_line(296, 194, 296, 206, BLUE);
+    lcd_draw_line(296, 194, 306, 200, BLUE);
+    lcd_show_string(30, 190, 240, 16, 16, "02 - Another Track.wav", BLUE);
+    lcd_show_xnum(30, 210, 83, 3, 12, 0x80, RED);
+}
+
+/**
+ * @brief       参考画法:在画面数组中画一个点(超出屏幕的点丢弃)
+ * @param       x, y  : 坐标
+ * @param       color : 颜色
+ * @retval      无
+ */
+static void bench_ref_pixel(int x, int y, uint16_t color)
+{
+    if (x >= 0 && y >= 0 && x < lcd_self.width && y < lcd_self.height)
+    {
+        bench_screen[y * lcd_self.width + x] = color;
+    }
+}
+
+/**
+ * @brief       参考画法:逐点画线(与lcd_draw_line相同的步进)
+ * @param       x1, y1, x2, y2 : 两端坐标
+ * @param       color          : 颜色
+ * @retval      无
+ */
+static void bench_ref_line(int x1, int y1, int x2, int y2, uint16_t color)
+{
+    int dx = abs(x2 - x1), dy = abs(y2 - y1);
+    int incx = (x2 > x1) - (x2 < x1), incy = (y2 > y1) - (y2 < y1);
+    int distance = (dx > dy) ? dx : dy;
+    int xerr = 0, yerr = 0;
+    int t;
+
+    for (t = 0; t <= distance + 1; t++)
+    {
+        bench_ref_pixel(x1, y1, color);
+        xerr += dx;
+        yerr += dy;
+
+        if (xerr > distance)
+        {
+            xerr -= distance;
+            x1 += incx;
+        }
+
+        if (yerr > distance)
+        {
+            yerr -= distance;
+            y1 += incy;
+        }
+    }
+}
+
+/**
+ * @brief       参考画法:逐点画圆(与lcd_draw_circle相同的点)
+ * @param       x0, y0 : 圆心
+ * @param       r      : 半径
+ * @param       color  : 颜色
+ * @retval      无
+ */
+static void bench_ref_circle(int x0, int y0, int r, uint16_t color)
+{
+    int a = 0, b = r;
+    int di = 3 - (r << 1);
+
+    while (a <= b)
+    {
+        bench_ref_pixel(x0 - b, y0 - a, color);
+        bench_ref_pixel(x0 + b, y0 - a, color);
+        bench_ref_pixel(x0 - a, y0 + b, color);
+        bench_ref_pixel(x0 - a, y0 - b, color);
+        bench_ref_pixel(x0 + b, y0 + a, color);
+        bench_ref_pixel(x0 + a, y0 - b, color);
+        bench_ref_pixel(x0 + a, y0 + b, color);
+        bench_ref_pixel(x0 - b, y0 + a, color);
+        a++;
+
+        if (di < 0)
+        {
+            di += 4 * a + 6;
+        }
+        else
+        {
+            di += 10 + 4 * (a - b);
+            b--;
+        }
+
+        bench_ref_pixel(x0 + a, y0 + b, color);
+    }
+}
+
+/**
+ * @brief       画线/画圆/画矩形的SPI传输量,并与逐点画法的结果核对
+ * @param       无
+ * @retval      不一致的像素数
+ */
+static uint32_t bench_ui_shapes(void)
+{
+    static const int16_t ends[][2] = { {319, 0}, {319, 60}, {319, 120}, {250, 239}, {160, 239}, {100, 239},
+                                       {0, 200}, {0, 120}, {0, 30}, {40, 0}, {150, 0}, {161, 0} };
+    uint32_t bad = 0;
+    uint32_t i;
+
+    lcd_clear(WHITE);
+    lcd_sim_reset_stats();
+
+    for (i = 0; i < sizeof(ends) / sizeof(ends[0]); i++)        /* 从中心向四周的斜线 */
+    {
+        lcd_draw_line(160, 120, ends[i][0], ends[i][1], (i & 1) ? RED : BLUE);
+    }
+
+    bench_ui_report("lcd_draw_line x12");
+
+    lcd_draw_circle(160, 120, 100, GREEN);
+    lcd_draw_circle(8, 8, 20, BLACK);                           /* 部分在屏幕外 */
+    bench_ui_report("lcd_draw_circle r100+r20");
+    lcd_draw_rectangle(20, 20, 299, 219, MAGENTA);
+    bench_ui_report("lcd_draw_rectangle");
+
+    for (i = 0; i < BENCH_SCREEN_PIXELS; i++)
+    {
+        bench_screen[i] = WHITE;
+    }
+
+    for (i = 0; i < sizeof(ends) / sizeof(ends[0]); i++)
+    {
+        bench_ref_line(160, 120, ends[i][0], ends[i][1], (i & 1) ? RED : BLUE);
+    }
+
+    bench_ref_circle(160, 120, 100, GREEN);
+    bench_ref_circle(8, 8, 20, BLACK);
+    bench_ref_line(20, 20, 299, 20, MAGENTA);
+    bench_ref_line(20, 20, 20, 219, MAGENTA);
+    bench_ref_line(20, 219, 299, 219, MAGENTA);
+    bench_ref_line(299, 20, 299, 219, MAGENTA);
+
+    for (i = 0; i < BENCH_SCREEN_PIXELS; i++)
+    {
+        bad += (lcd_sim_pixel(i % lcd_self.width, i / lcd_self.width) != bench_screen[i]);
+    }
+
+    return bad;
+}
+
+/**
+ * @brief       常用LCD绘图函数的SPI传输量(播放界面用到的操作),同时核对画面
+ * @param       无
+ * @retval      不正确的像素数
+ */
+static uint32_t bench_ui(void)
+{
+    uint32_t bad = 0;
+    uint32_t i;
+
+    bench_mem_report("display memory");
+    lcd_sim_reset_stats();
+    lcd_fill(30, 190, 239, 205, BLUE);                          /* 一行16点文字的区域 */
+    bench_ui_report("lcd_fill 210x16");
+    bad += bench_ui_check(30, 190, 239, 205, BLUE) + bench_ui_check(30, 206, 239, 206, WHITE);
+    lcd_clear(WHITE);
+    bench_ui_report("lcd_clear");
+    bad += bench_ui_check(0, 0, lcd_self.width - 1, lcd_self.height - 1, WHITE);
+    lcd_show_string(30, 190, 210, 16, 16, "Playing: 01 - Track.wav", RED);  /* 歌名(非叠加方式) */
+    bench_ui_report("lcd_show_string 23x16");
+    bad += bench_ui_text(30, 190, "Playing: 01 - Track.wav", 16, RED, WHITE);
+    lcd_fill(30, 210, 89, 221, BLUE);
+    lcd_sim_reset_stats();
+    lcd_show_xnum(30, 210, 1234, 5, 12, 0x81, YELLOW);                 /* 叠加方式,高位补0 */
+    bench_ui_report("lcd_show_xnum 5x12 overlay");
+    bad += bench_ui_text(30, 210, "01234", 12, YELLOW, BLUE);
+    bad += bench_ui_shapes();
+    lcd_clear(WHITE);
+    lcd_sim_reset_stats();
+    bench_ui_scene();                                           /* 直接画到屏幕 */
+    bench_ui_report("ui scene direct");
+
+    for (i = 0; i < BENCH_SCREEN_PIXELS; i++)
+    {
+        bench_screen[i] = lcd_sim_pixel(i % lcd_self.width, i / lcd_self.width);
+    }
+
+    lcd_clear(BLACK);
+    lcd_sim_reset_stats();
+
+    if (lcd_fb_enable(1) == 0)                                  /* 同样的画面经帧缓存发送 */
+    {
+        lcd_clear(WHITE);
+        lcd_flush();
+        bench_ui_report("lcd_clear framebuffer");
+        bench_ui_scene();
+        lcd_flush();
+        bench_ui_report("ui scene framebuffer");
+        bench_mem_report("display memory framebuffer");
+        lcd_fb_enable(0);
+
+        for (i = 0; i < BENCH_SCREEN_PIXELS; i++)
+        {
+            bad += (lcd_sim_pixel(i % lcd_self.width, i / lcd_self.width) != bench_screen[i]);
+        }
+    }
+
+    printf("\n");
+
+    if (bad)
+    {
+        fprintf(stderr, "lcd primitives: %lu pixels wrong\n", (unsigned long)bad);
+    }
+
+    return bad;
+}
+
+/**
+ * @brief       按脏矩形更新参考画面(帧坐标,面板字节序)
+ * @param       pack   : 动画包
+ * @param       index  : 帧序号
+ * @param       canvas : 参考画面
+ * @retval      无
+ */
+static void bench_reference(const anim_pack_t *pack, uint16_t index, uint16_t *canvas)
+{
+    anim_decoder_t dec;
+    anim_rect_t rect;
+    uint16_t y;
+
+    if (anim_decoder_start(&dec, pack, index) != 0)
+    {
+        return;
+    }
+
+    while (anim_next_rect(&dec, &rect) == 0)
+    {
+        if (rect.x + rect.w > pack->width || rect.y + rect.h > pack->height)
+        {
+            continue;
+        }
+
+        for (y = 0; y < rect.h; y++)
+        {
+            anim_decode(&dec, canvas + (rect.y + y) * pack->width + rect.x, rect.w);
+        }
+    }
+}
+
+/**
+ * @brief       判断屏幕上的点是否在文字叠加层内(位置见compose.c的compose_cfg)
+ * @param       x, y : 坐标
+ * @retval      1,是;0,否
+ */
+static uint8_t bench_in_text(int x, int y)
+{
+    return (x >= 30 && x < 290 && y >= 190 && y < 210 + COMPOSE_FONT_SIZE);
+}
+
+/**
+ * @brief       设置全部叠加层的文字
+ * @param       on : 1,显示bench_texts;0,清空
+ * @retval      无
+ */
+static void bench_set_texts(uint8_t on)
+{
+    uint8_t id;
+
+    for (id = 0; id < COMPOSE_LAYERS; id++)
+    {
+        compose_set_text(id, on ? bench_texts[id] : "");
+    }
+
+    compose_update();
+    lcd_wait_data();
+}
+
+/**
+ * @brief       核对模拟显存与参考画面(只在1:1显示时核对)
+ * @param       pack   : 动画包
+ * @param       canvas : 参考画面
+ * @param       text   : 1,叠加层内文字颜色的像素不算错(叠加着文字);0,逐点核对
+ * @retval      不一致的像素数
+ */
+static uint32_t bench_verify(const anim_pack_t *pack, const uint16_t *canvas, uint8_t text)
+{
+    uint32_t bad = 0;
+    uint16_t c;
+    int x, y;
+    int px, py;
+
+    for (y = 0; y < pack->height; y++)
+    {
+        for (x = 0; x < pack->width; x++)
+        {
+            px = bench_anim.blit.dst_x + x;
+            py = bench_anim.blit.dst_y + y;
+
+            if (px < bench_anim.blit.clip_x || px >= bench_anim.blit.clip_x + bench_anim.blit.clip_w ||
+                py < bench_anim.blit.clip_y || py >= bench_anim.blit.clip_y + bench_anim.blit.clip_h)
+            {
+                continue;
+            }
+
+            c = canvas[y * pack->width + x];
+
+            if (lcd_sim_pixel(px, py) != (uint16_t)((c >> 8) | (c << 8)) &&
+                !(text && bench_in_text(px, py) && (lcd_sim_pixel(px, py) == RED || lcd_sim_pixel(px, py) == BLUE)))
+            {
+                bad++;
+            }
+        }
+    }
+
+    return bad;
+}
+
+/**
+ * @brief       交叉淡入淡出核对:从当前画面(影子帧)以BENCH_XFADE_ALPHA混合画出首帧
+ * @note        首帧为关键帧,屏幕上应是首帧与影子帧的混合结果,影子帧保持不变;调用前须已清空文字
+ * @param       pack   : 动画包
+ * @param       canvas : 当前画面的参考(与影子帧相同)
+ * @retval      不一致的像素数
+ */
+static uint32_t bench_crossfade(const anim_pack_t *pack, const uint16_t *canvas)
+{
+    size_t n = (size_t)pack->width * pack->height;
+    uint16_t *expect = calloc(n, sizeof(uint16_t));
+    uint32_t bad = 0;
+
+    if (expect == NULL)
+    {
+        return 0;
+    }
+
+    bench_reference(pack, 0, expect);
+    anim_blend(expect, canvas, n, BENCH_XFADE_ALPHA);
+    bench_anim.alpha = BENCH_XFADE_ALPHA;
+    bad += bench_draw_frame(pack, 0);
+    bench_anim.alpha = ANIM_BLEND_MAX;
+
+    if (!bench_anim.blit.scaled)
+    {
+        bad += bench_verify(pack, expect, 0);
+    }
+
+    bad += (bench_anim.shadow != NULL && memcmp(bench_anim.shadow, canvas, n * 2) != 0);
+    free(expect);
+
+    return bad;
+}
+
+/**
+ * @brief       纯解码耗时(不经过LCD驱动)
+ * @param       pack   : 动画包
+ * @param       frames : 帧数
+ * @param       repeat : 重复次数
+ * @retval      平均每帧耗时(ns)
+ */
+static uint64_t bench_decode_time(const anim_pack_t *pack, uint16_t frames, uint32_t repeat)
+{
+    anim_decoder_t dec;
+    anim_rect_t rect;
+    uint64_t start = bench_now_ns();
+    uint32_t r;
+    uint16_t i;
+
+    for (r = 0; r < repeat; r++)
+    {
+        for (i = 0; i < frames; i++)
+        {
+            if (anim_decoder_start(&dec, pack, i) != 0)
+            {
+                continue;
+            }
+
+            while (anim_next_rect(&dec, &rect) == 0)
+            {
+                while (anim_decode(&dec, bench_pixels, LCD_ANIM_CHUNK_PIXELS) > 0)
+                {
+                }
+            }
+        }
+    }
+
+    return (bench_now_ns() - start) / ((uint64_t)repeat * frames);
+}
+
+/**
+ * @brief       读入整个文件
+ * @param       path : 文件路径
+ * @param       size : 文件长度
+ * @retval      文件内容(用完后free),NULL表示失败
+ */
+static uint8_t *bench_load(const char *path, uint32_t *size)
+{
+    FILE *f = fopen(path, "rb");
+    uint8_t *data = NULL;
+    long len;
+
+    if (f == NULL)
+    {
+        return NULL;
+    }
+
+    if (fseek(f, 0, SEEK_END) == 0 && (len = ftell(f)) > 0 && fseek(f, 0, SEEK_SET) == 0)
+    {
+        data = malloc(len);
+
+        if (data != NULL && fread(data, 1, len, f) != (size_t)len)
+        {
+            free(data);
+            data = NULL;
+        }
+
+        *size = len;
+    }
+
+    fclose(f);
+
+    return data;
+}
+
+/**
+ * @brief       取得包名(文件名去掉目录和扩展名)
+ * @param       path : 文件路径
+ * @param       name : 包名
+ * @param       len  : name的大小
+ * @retval      无
+ */
+static void bench_name(const char *path, char *name, size_t len)
+{
+    const char *base = strrchr(path, '/');
+    char *dot;
+
+    snprintf(name, len, "%s", base ? base + 1 : path);
+    dot = strrchr(name, '.');
+
+    if (dot != NULL)
+    {
+        *dot = '\0';
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    static const char *codec_names[] = {"?", "rle16", "pal8", "pal4"};
+    static const char *mode_names[] = {"center", "integer", "fit", "stretch"};
+    const char *ppm_dir = NULL;
+    uint32_t max_bytes = 0;
+    uint32_t max_trans = 0;
+    uint32_t repeat = 20;
+    uint8_t mode = ANIM_BLIT_INTEGER;
+    lcd_sim_stats_t st;
+    anim_pack_t pack;
+    uint16_t *canvas;
+    uint8_t *data;
+    uint32_t size;
+    uint32_t bad;
+    uint16_t frames;
+    uint16_t i;
+    uint64_t draw_ns;
+    uint64_t decode_ns;
+    double per_frame_bytes;
+    double per_frame_trans;
+    char name[64];
+    char path[512];
+    int res = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "m:n:p:B:T:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'm':
+                for (mode = 0; mode < 4 && strcmp(optarg, mode_names[mode]) != 0; mode++)
+                {
+                }
+
+                if (mode >= 4)
+                {
+                    fprintf(stderr, "unknown blit mode %s\n", optarg);
+                    return 2;
+                }
+                break;
+
+            case 'n':
+                repeat = strtoul(optarg, NULL, 0);
+                repeat = repeat ? repeat : 1;
+                break;
+
+            case 'p':
+                ppm_dir = optarg;
+                break;
+
+            case 'B':
+                max_bytes = strtoul(optarg, NULL, 0);
+                break;
+
+            case 'T':
+                max_trans = strtoul(optarg, NULL, 0);
+                break;
+
+            default:
+                fprintf(stderr, "usage: %s [-m center|integer|fit|stretch] [-n repeat] [-p ppm_dir] [-B max_bytes] [-T max_trans] pack.anm...\n", argv[0]);
+                return 2;
+        }
+    }
+
+    if (optind >= argc)
+    {
+        fprintf(stderr, "no animation packs given\n");
+        return 2;
+    }
+
+    lcd_init();                                                 /* 与板上相同的初始化:横屏320x240,白色清屏 */
+    compose_init();
+    lcd_anim_init();                                            /* 与emotion_init()相同,计入显示缓存统计 */
+    res = bench_ui() ? 1 : 0;
+
+    printf("%-26s %-6s %6s %11s %11s %9s %10s %10s %9s\n", "pack", "codec", "frames",
+           "bytes/frm", "trans/frm", "win/frm", "decode_us", "draw_us", "spi_us");
+
+    for (; optind < argc; optind++)
+    {
+        bench_name(argv[optind], name, sizeof(name));
+        data = bench_load(argv[optind], &size);
+
+        if (data == NULL || anim_pack_open(&pack, data, size) != 0)
+        {
+            fprintf(stderr, "%s: not a valid animation pack\n", argv[optind]);
+            free(data);
+            res = 1;
+            continue;
+        }
+
+        frames = pack.frame_count + ((pack.flags & ANIM_FLAG_LOOP) ? 1 : 0);  /* 回环帧也播放一次 */
+        canvas = calloc((size_t)pack.width * pack.height, sizeof(uint16_t));
+        bench_anim.shadow = calloc((size_t)pack.width * pack.height, sizeof(uint16_t));
+        bench_anim.shadow_w = pack.width;
+        bench_anim.shadow_h = pack.height;
+        anim_blit_init(&bench_anim.blit, pack.width, pack.height, 0, 0, lcd_self.width, lcd_self.height, mode);
+        lcd_clear(WHITE);
+        bench_set_texts(1);                                     /* 文字在播放前画好,不计入每帧的传输 */
+        lcd_sim_reset_stats();
+        bad = 0;
+        draw_ns = 0;
+
+        for (i = 0; i < frames; i++)
+        {
+            uint64_t start = bench_now_ns();
+
+            if (bench_draw_frame(&pack, i) != 0)
+            {
+                fprintf(stderr, "%s: frame %u is corrupt\n", name, i);
+                res = 1;
+                break;
+            }
+
+            draw_ns += bench_now_ns() - start;
+
+            if (canvas != NULL)
+            {
+                bench_reference(&pack, i, canvas);
+                bad += bench_anim.blit.scaled ? 0 : bench_verify(&pack, canvas, 1);
+
+                if (bench_anim.shadow != NULL && memcmp(bench_anim.shadow, canvas, (size_t)pack.width * pack.height * 2) != 0)
+                {
+                    fprintf(stderr, "%s: shadow frame differs from the reference decode after frame %u\n", name, i);
+                    bad++;
+                }
+            }
+
+            if (ppm_dir != NULL)
+            {
+                snprintf(path, sizeof(path), "%s/%s_%03u.ppm", ppm_dir, name, i);
+
+                if (lcd_sim_dump_ppm(path, lcd_self.width, lcd_self.height) != 0)
+                {
+                    fprintf(stderr, "%s: cannot write\n", path);
+                }
+            }
+        }
+
+        lcd_sim_get_stats(&st);
+        bench_set_texts(0);                                     /* 清空文字后应露出叠加层保存的动画背景 */
+
+        if (canvas != NULL && i == frames)
+        {
+            bad += bench_anim.blit.scaled ? 0 : bench_verify(&pack, canvas, 0);
+            bad += bench_crossfade(&pack, canvas);
+        }
+
+        decode_ns = bench_decode_time(&pack, frames, repeat);
+        per_frame_bytes = (double)st.bytes / frames;
+        per_frame_trans = (double)st.transactions / frames;
+
+        printf("%-26s %-6s %6u %11.0f %11.1f %9.1f %10.1f %10.1f %9.0f\n", name,
+               codec_names[pack.codec <= ANIM_CODEC_PAL4 ? pack.codec : 0], frames,
+               per_frame_bytes, per_frame_trans, (double)st.windows / frames,
+               decode_ns / 1000.0, draw_ns / 1000.0 / frames, per_frame_bytes * 8 * 1000000 / BENCH_SPI_HZ);
+
+        if (bad)
+        {
+            fprintf(stderr, "%s: %lu pixels differ from the reference decode\n", name, (unsigned long)bad);
+            res = 1;
+        }
+
+        if ((max_bytes && per_frame_bytes > max_bytes) || (max_trans && per_frame_trans > max_trans))
+        {
+            fprintf(stderr, "%s: over budget (bytes/frame limit %lu, trans/frame limit %lu)\n", name,
+                    (unsigned long)max_bytes, (unsigned long)max_trans);
+            res = 1;
+        }
+
+        free(bench_anim.shadow);
+        bench_anim.shadow = NULL;
+        free(canvas);
+        free(data);
+    }
+
+    return res;
+}
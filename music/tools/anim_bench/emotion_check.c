@@ -0,0 +1,492 @@
+/**
+ ****************************************************************************************************
+ * @file        emotion_check.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       表情播放状态机的主机端检查
+ *              直接包含emotion_play.c(可以访问其中的静态状态),用模拟时间驱动播放任务的主循环:
+ *              命令队列按脚本在指定时刻送出命令,等待命令时模拟时间前进,帧绘制经LCD模拟器完成;
+ *              动画包从 <目录>/<包名><后缀>.anm 读入,代替Flash动画分区
+ *              每个场景记录依次打开的动画包、序列结束时是否决定交叉淡入(xfade)
+ *              以及是否画出了淡入淡出的混合帧(fade),与期望的记录比较;
+ *              同时检查在SD卡上查找动画包的次数(每个序列一次,不随循环轮数增加)
+ *
+ *              用法: emotion_check 目录 后缀    如 emotion_check packs _rgb565_delta
+ ****************************************************************************************************
+ */
+
+#include "emotion_play.c"
+#include "text.h"
+#include "lcd_sim.h"
+
+
+#define CHECK_LOG_SIZE          512         /* 记录的最大长度 */
+#define CHECK_PACKS             8           /* 最多读入的动画包数 */
+
+/* 脚本中的一条命令 */
+typedef struct
+{
+    uint32_t ms;                            /* 送出时刻(从场景开始计) */
+    uint8_t cmd;                            /* EMOTION_CMD_xxx */
+    uint8_t id;                             /* 表情编号 */
+} check_cmd_t;
+
+/* 已读入的动画包 */
+typedef struct
+{
+    char name[32];
+    uint8_t *data;
+    uint32_t size;
+} check_pack_t;
+
+struct host_queue
+{
+    emotion_cmd_t item[EMOTION_QUEUE_LEN];
+    uint32_t head;
+    uint32_t count;
+};
+
+static int64_t check_now_us;                                    /* 模拟时间 */
+static int64_t check_start_us;                                  /* 当前场景的开始时刻 */
+static struct host_queue check_queue;
+static const check_cmd_t *check_script;                         /* 当前场景的命令脚本 */
+static uint32_t check_script_len;
+static uint32_t check_script_pos;
+static char check_log[CHECK_LOG_SIZE];
+static char check_last[32];
+static check_pack_t check_packs[CHECK_PACKS];
+static const char *check_dir;
+static const char *check_suffix;
+static uint32_t check_stream_opens;                             /* 在SD卡上查找动画包的次数 */
+static uint8_t check_cache_missing;                             /* 预读缓存是否已记录SD卡上没有动画包 */
+
+/**
+ * @brief       追加一条记录(与上一条相同时不重复记录,如循环序列的每一轮)
+ * @param       item : 记录
+ * @retval      无
+ */
+static void check_note(const char *item)
+{
+    if (strcmp(check_last, item) == 0)
+    {
+        return;
+    }
+
+    snprintf(check_last, sizeof(check_last), "%s", item);
+
+    if (check_log[0])
+    {
+        strncat(check_log, " ", sizeof(check_log) - strlen(check_log) - 1);
+    }
+
+    strncat(check_log, item, sizeof(check_log) - strlen(check_log) - 1);
+}
+
+/**
+ * @brief       把脚本中下一条命令放入队列,模拟时间前进到它的送出时刻
+ * @param       limit : 最晚送出时刻(us),-1表示不限
+ * @retval      1,已送出;0,在limit之前没有命令
+ */
+static uint8_t check_deliver(int64_t limit)
+{
+    const check_cmd_t *c;
+    emotion_cmd_t cmd;
+    int64_t at;
+
+    if (check_script_pos >= check_script_len)
+    {
+        return 0;
+    }
+
+    c = &check_script[check_script_pos];
+    at = check_start_us + c->ms * 1000LL;
+
+    if (limit >= 0 && at > limit)
+    {
+        return 0;
+    }
+
+    if (at > check_now_us)
+    {
+        check_now_us = at;
+    }
+
+    memset(&cmd, 0, sizeof(cmd));
+    cmd.cmd = c->cmd;
+    cmd.id = c->id;
+    check_script_pos++;
+
+    return xQueueSend(&check_queue, &cmd, 0) == pdTRUE;
+}
+
+/* 主机端替代:FreeRTOS,只有一个命令队列 */
+QueueHandle_t xQueueCreate(UBaseType_t len, UBaseType_t item_size)
+{
+    (void)len;
+    (void)item_size;
+    return &check_queue;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    (void)queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks)
+{
+    (void)ticks;
+
+    if (queue->count >= EMOTION_QUEUE_LEN)
+    {
+        return pdFALSE;
+    }
+
+    memcpy(&queue->item[(queue->head + queue->count++) % EMOTION_QUEUE_LEN], item, sizeof(emotion_cmd_t));
+
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks)
+{
+    int64_t limit = (ticks == portMAX_DELAY) ? -1 : check_now_us + ticks * portTICK_PERIOD_MS * 1000LL;
+
+    if (queue->count == 0 && !check_deliver(limit))
+    {
+        if (limit >= 0)
+        {
+            check_now_us = limit;                               /* 等待超时 */
+        }
+
+        return pdFALSE;
+    }
+
+    memcpy(item, &queue->item[queue->head], sizeof(emotion_cmd_t));
+    queue->head = (queue->head + 1) % EMOTION_QUEUE_LEN;
+    queue->count--;
+
+    return pdTRUE;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t func, const char *name, uint32_t stack, void *param, UBaseType_t prio, TaskHandle_t *handle)
+{
+    (void)func;
+    (void)name;
+    (void)stack;
+    (void)param;
+    (void)prio;
+    *handle = NULL;                                             /* 播放任务的主循环由check_scene()执行 */
+    return pdPASS;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(check_now_us / (portTICK_PERIOD_MS * 1000));
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return NULL;
+}
+
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action)
+{
+    (void)task;
+    (void)value;
+    (void)action;
+    return pdTRUE;
+}
+
+BaseType_t xTaskNotifyWait(uint32_t clear_entry, uint32_t clear_exit, uint32_t *value, TickType_t ticks)
+{
+    (void)clear_entry;
+    (void)clear_exit;
+    (void)value;
+    (void)ticks;
+    return pdFALSE;
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return check_now_us;
+}
+
+/* 主机端替代:没有字库,文字叠加层的汉字为空白 */
+void text_get_hz_mat(unsigned char *code, unsigned char *mat, uint8_t size)
+{
+    (void)code;
+    memset(mat, 0, (size / 8 + ((size % 8) ? 1 : 0)) * size);
+}
+
+void text_show_string(uint16_t x, uint16_t y, uint16_t width, uint16_t height, char *str, uint8_t size, uint8_t mode, uint32_t color)
+{
+    (void)mode;
+    lcd_show_string(x, y, width, height, size, str, color);
+}
+
+/* 主机端替代:没有音频在播放,排期使用系统时间 */
+uint8_t wav_get_clock(int64_t *us)
+{
+    (void)us;
+    return 1;
+}
+
+uint8_t audio_meter_get(audio_meter_t *meter)
+{
+    (void)meter;
+    return 1;
+}
+
+/* 主机端替代:没有SD卡,预读缓存为空 */
+uint8_t anim_cache_init(void)
+{
+    return 0;
+}
+
+uint8_t anim_cache_prefetch(const char *name)
+{
+    (void)name;
+    return 0;
+}
+
+const uint8_t *anim_cache_get(const char *name, uint32_t *size)
+{
+    (void)name;
+    (void)size;
+    return NULL;
+}
+
+void anim_cache_put(const uint8_t *data)
+{
+    (void)data;
+}
+
+uint8_t anim_cache_missing(const char *name)
+{
+    (void)name;
+    return check_cache_missing;
+}
+
+void anim_cache_get_stats(anim_cache_stats_t *stats)
+{
+    memset(stats, 0, sizeof(anim_cache_stats_t));
+}
+
+uint8_t anim_stream_open(anim_stream_t *s, const char *name)
+{
+    (void)s;
+    (void)name;
+    check_stream_opens++;               /* 主机上没有SD卡,总是打不开 */
+    return 1;
+}
+
+const uint8_t *anim_stream_frame(anim_stream_t *s, uint16_t index, uint16_t next, uint32_t *size)
+{
+    (void)s;
+    (void)index;
+    (void)next;
+    (void)size;
+    return NULL;
+}
+
+void anim_stream_close(anim_stream_t *s)
+{
+    (void)s;
+}
+
+/**
+ * @brief       主机端替代:在Flash动画分区中查找动画包(从文件读入),并记录打开的包名
+ * @param       name : 包名
+ * @param       data : 动画包数据
+ * @param       size : 动画包长度
+ * @retval      0,成功;1,没有该动画包
+ */
+uint8_t anim_flash_find(const char *name, const uint8_t **data, uint32_t *size)
+{
+    check_pack_t *p = NULL;
+    char path[512];
+    FILE *f;
+    long len;
+    int i;
+
+    check_note(name);
+
+    for (i = 0; i < CHECK_PACKS && p == NULL; i++)
+    {
+        if (check_packs[i].data == NULL || strcmp(check_packs[i].name, name) == 0)
+        {
+            p = &check_packs[i];
+        }
+    }
+
+    if (p == NULL)
+    {
+        return 1;
+    }
+
+    if (p->data == NULL)
+    {
+        snprintf(path, sizeof(path), "%s/%s%s.anm", check_dir, name, check_suffix);
+        f = fopen(path, "rb");
+
+        if (f == NULL)
+        {
+            return 1;
+        }
+
+        fseek(f, 0, SEEK_END);
+        len = ftell(f);
+        fseek(f, 0, SEEK_SET);
+        p->data = malloc(len);
+
+        if (p->data == NULL || fread(p->data, 1, len, f) != (size_t)len)
+        {
+            fclose(f);
+            free(p->data);
+            p->data = NULL;
+            return 1;
+        }
+
+        fclose(f);
+        snprintf(p->name, sizeof(p->name), "%s", name);
+        p->size = len;
+    }
+
+    *data = p->data;
+    *size = p->size;
+
+    return 0;
+}
+
+/**
+ * @brief       叠加层:记录淡入淡出的混合帧
+ * @param       参数同compose_apply()
+ * @retval      无
+ */
+static void check_overlay(uint16_t x, uint16_t y, uint16_t w, uint32_t pos, uint16_t *pixels, uint32_t len)
+{
+    if (emotion_anim.alpha < ANIM_BLEND_MAX)
+    {
+        check_note("fade");
+    }
+
+    compose_apply(x, y, w, pos, pixels, len);
+}
+
+/**
+ * @brief       运行一个场景:与emotion_player_task()相同的主循环,脚本中的命令都执行完、播放任务空闲时结束
+ * @param       name   : 场景名
+ * @param       script : 命令脚本(按时刻排列)
+ * @param       len    : 命令数
+ * @param       expect : 期望的记录
+ * @param       opens  : 期望在SD卡上查找动画包的次数
+ * @retval      0,与期望相同;1,不同
+ */
+static int check_scene(const char *name, const check_cmd_t *script, uint32_t len, const char *expect, uint32_t opens)
+{
+    emotion_cmd_t cmd;
+
+    check_script = script;
+    check_script_len = len;
+    check_script_pos = 0;
+    check_start_us = check_now_us;
+    check_log[0] = '\0';
+    check_last[0] = '\0';
+    check_stream_opens = 0;
+    emotion_request = EMOTION_NONE;
+    emotion_current = EMOTION_NONE;
+    emotion_xfade = false;
+    emotion_shadow_fresh = false;
+
+    while (1)
+    {
+        if (emotion_request == EMOTION_NONE || emotion_request >= EMOTION_COUNT)
+        {
+            if (check_script_pos >= check_script_len && check_queue.count == 0)
+            {
+                break;
+            }
+
+            if (xQueueReceive(emotion_queue, &cmd, portMAX_DELAY) == pdTRUE)
+            {
+                emotion_apply(&cmd);
+            }
+
+            continue;
+        }
+
+        emotion_run(emotion_request);
+
+        if (emotion_xfade)
+        {
+            check_note("xfade");
+        }
+    }
+
+    if (strcmp(check_log, expect) != 0)
+    {
+        fprintf(stderr, "%s:\n  got    %s\n  expect %s\n", name, check_log, expect);
+        return 1;
+    }
+
+    if (check_stream_opens != opens)
+    {
+        fprintf(stderr, "%s: %lu stream opens, expect %lu\n", name, (unsigned long)check_stream_opens, (unsigned long)opens);
+        return 1;
+    }
+
+    printf("%-28s %s (%lu stream opens)\n", name, check_log, (unsigned long)check_stream_opens);
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    /* 换曲:只发一条快速切换命令,开心的循环序列之后应交叉淡入难过,不播放开心的退场 */
+    static const check_cmd_t track_change[] = {
+        { 0,    EMOTION_CMD_SWITCH, EMOTION_HAPPY },
+        { 3000, EMOTION_CMD_SWITCH, EMOTION_SAD },
+        { 6000, EMOTION_CMD_STOP,   EMOTION_NONE },
+    };
+    /* 连续两首都是开心:第二条命令不打断循环序列,不重新退场/入场 */
+    static const check_cmd_t same_emotion[] = {
+        { 0,    EMOTION_CMD_SWITCH, EMOTION_HAPPY },
+        { 2500, EMOTION_CMD_SWITCH, EMOTION_HAPPY },
+        { 5000, EMOTION_CMD_SWITCH, EMOTION_SAD },
+        { 8000, EMOTION_CMD_STOP,   EMOTION_NONE },
+    };
+    /* 停止:播放退场序列,不交叉淡入 */
+    static const check_cmd_t stop[] = {
+        { 0,    EMOTION_CMD_SWITCH, EMOTION_HAPPY },
+        { 3000, EMOTION_CMD_STOP,   EMOTION_NONE },
+    };
+    int res = 0;
+
+    if (argc != 3)
+    {
+        fprintf(stderr, "usage: %s pack_dir suffix\n", argv[0]);
+        return 2;
+    }
+
+    check_dir = argv[1];
+    check_suffix = argv[2];
+    lcd_init();
+    emotion_init();
+
+    if (emotion_shadow == NULL)
+    {
+        fprintf(stderr, "no shadow frame, crossfade cannot be checked\n");
+        return 1;
+    }
+
+    emotion_anim.overlay = check_overlay;
+    res |= check_scene("track change", track_change, 3,
+                       "excited_in excited_loop xfade sad_in fade sad_loop sad_out", 5);
+    res |= check_scene("same emotion", same_emotion, 4,
+                       "excited_in excited_loop xfade sad_in fade sad_loop sad_out", 5);
+    res |= check_scene("stop", stop, 2, "excited_in excited_loop excited_out", 3);
+    /* 预读缓存已记录SD卡上没有这些动画包:不再打开SD卡上的文件 */
+    check_cache_missing = 1;
+    res |= check_scene("stop, known missing", stop, 2, "excited_in excited_loop excited_out", 0);
+
+    return res;
+}
@@ -0,0 +1,42 @@
+/**
+ ****************************************************************************************************
+ * @file        gpio.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       主机端模拟:GPIO驱动(电平写入LCD模拟器,用于区分命令/数据)
+ ****************************************************************************************************
+ */
+
+#ifndef __HOST_GPIO_H
+#define __HOST_GPIO_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+
+typedef int gpio_num_t;
+
+#define GPIO_NUM_11             11
+#define GPIO_NUM_12             12
+#define GPIO_NUM_13             13
+#define GPIO_NUM_21             21
+#define GPIO_NUM_40             40
+
+#define GPIO_INTR_DISABLE       0
+#define GPIO_MODE_OUTPUT        2
+#define GPIO_PULLDOWN_DISABLE   0
+#define GPIO_PULLUP_ENABLE      1
+
+typedef struct
+{
+    uint64_t pin_bit_mask;
+    int mode;
+    int pull_up_en;
+    int pull_down_en;
+    int intr_type;
+} gpio_config_t;
+
+esp_err_t gpio_config(const gpio_config_t *cfg);
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level);
+
+#endif
@@ -0,0 +1,63 @@
+/**
+ ****************************************************************************************************
+ * @file        spi_master.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       主机端模拟:SPI主机驱动(只包含LCD驱动用到的类型)
+ ****************************************************************************************************
+ */
+
+#ifndef __HOST_SPI_MASTER_H
+#define __HOST_SPI_MASTER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+
+typedef enum
+{
+    SPI1_HOST = 0,
+    SPI2_HOST = 1,
+    SPI3_HOST = 2,
+} spi_host_device_t;
+
+typedef struct spi_device_t *spi_device_handle_t;
+
+#define SPI_TRANS_USE_RXDATA    (1 << 2)    /* 接收数据放在rx_data中 */
+#define SPI_TRANS_USE_TXDATA    (1 << 3)    /* 发送数据放在tx_data中 */
+
+typedef struct
+{
+    uint32_t flags;
+    uint16_t cmd;
+    uint64_t addr;
+    size_t length;                          /* 数据长度(位) */
+    size_t rxlength;
+    void *user;
+    union
+    {
+        const void *tx_buffer;
+        uint8_t tx_data[4];
+    };
+    union
+    {
+        void *rx_buffer;
+        uint8_t rx_data[4];
+    };
+} spi_transaction_t;
+
+typedef struct
+{
+    int mode;
+    int clock_speed_hz;
+    int spics_io_num;
+    uint32_t flags;
+    int queue_size;
+    void (*pre_cb)(spi_transaction_t *trans);
+    void (*post_cb)(spi_transaction_t *trans);
+} spi_device_interface_config_t;
+
+esp_err_t spi_bus_add_device(spi_host_device_t host, const spi_device_interface_config_t *dev_config, spi_device_handle_t *handle);
+
+#endif
@@ -0,0 +1,19 @@
+/**
+ ****************************************************************************************************
+ * @file        esp_attr.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       主机端模拟:ESP-IDF内存属性
+ ****************************************************************************************************
+ */
+
+#ifndef __HOST_ESP_ATTR_H
+#define __HOST_ESP_ATTR_H
+
+
+#define WORD_ALIGNED_ATTR       __attribute__((aligned(4)))
+#define DRAM_ATTR
+#define DMA_ATTR                WORD_ALIGNED_ATTR
+#define IRAM_ATTR
+
+#endif
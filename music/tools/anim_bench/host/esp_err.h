@@ -0,0 +1,25 @@
+/**
+ ****************************************************************************************************
+ * @file        esp_err.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       主机端模拟:ESP-IDF错误码
+ ****************************************************************************************************
+ */
+
+#ifndef __HOST_ESP_ERR_H
+#define __HOST_ESP_ERR_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+
+typedef int esp_err_t;
+
+#define ESP_OK                  0
+#define ESP_FAIL                -1
+#define ESP_ERR_NO_MEM          0x101
+
+#define ESP_ERROR_CHECK(x)      do{ if ((x) != ESP_OK) { fprintf(stderr, "%s failed\n", #x); abort(); } }while(0)
+
+#endif
@@ -0,0 +1,25 @@
+/**
+ ****************************************************************************************************
+ * @file        esp_heap_caps.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       主机端模拟:按能力申请内存(全部由malloc代替)
+ ****************************************************************************************************
+ */
+
+#ifndef __HOST_ESP_HEAP_CAPS_H
+#define __HOST_ESP_HEAP_CAPS_H
+
+#include <stdlib.h>
+
+
+#define MALLOC_CAP_DMA          (1 << 3)
+#define MALLOC_CAP_8BIT         (1 << 2)
+#define MALLOC_CAP_SPIRAM       (1 << 10)
+#define MALLOC_CAP_INTERNAL     (1 << 11)
+
+#define heap_caps_malloc(size, caps)        malloc(size)
+#define heap_caps_free(ptr)                 free(ptr)
+#define heap_caps_get_free_size(caps)       ((size_t)0)
+
+#endif
@@ -0,0 +1,21 @@
+/**
+ ****************************************************************************************************
+ * @file        esp_log.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       主机端模拟:ESP-IDF日志
+ ****************************************************************************************************
+ */
+
+#ifndef __HOST_ESP_LOG_H
+#define __HOST_ESP_LOG_H
+
+#include <stdio.h>
+#include "esp_err.h"
+
+
+#define ESP_LOGE(tag, fmt, ...) fprintf(stderr, "E %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) fprintf(stderr, "W %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) do{ (void)(tag); }while(0)
+
+#endif
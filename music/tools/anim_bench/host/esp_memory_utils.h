@@ -0,0 +1,18 @@
+/**
+ ****************************************************************************************************
+ * @file        esp_memory_utils.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       主机端模拟:判断地址所在的存储器(主机上没有PSRAM)
+ ****************************************************************************************************
+ */
+
+#ifndef __HOST_ESP_MEMORY_UTILS_H
+#define __HOST_ESP_MEMORY_UTILS_H
+
+#include <stdbool.h>
+
+
+#define esp_ptr_external_ram(p)             ((void)(p), false)
+
+#endif
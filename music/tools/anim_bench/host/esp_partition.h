@@ -0,0 +1,14 @@
+/**
+ ****************************************************************************************************
+ * @file        esp_partition.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       主机端模拟:ESP-IDF分区表(anim_flash.h的声明不用其中的类型)
+ ****************************************************************************************************
+ */
+
+#ifndef __HOST_ESP_PARTITION_H
+#define __HOST_ESP_PARTITION_H
+
+
+#endif
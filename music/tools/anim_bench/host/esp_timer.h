@@ -0,0 +1,18 @@
+/**
+ ****************************************************************************************************
+ * @file        esp_timer.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       主机端模拟:ESP-IDF高精度定时器(只有声明,用到的程序自行实现)
+ ****************************************************************************************************
+ */
+
+#ifndef __HOST_ESP_TIMER_H
+#define __HOST_ESP_TIMER_H
+
+#include <stdint.h>
+
+
+int64_t esp_timer_get_time(void);
+
+#endif
@@ -0,0 +1,18 @@
+/**
+ ****************************************************************************************************
+ * @file        ff.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       主机端模拟:FatFs(只有动画包流的声明用到的类型)
+ ****************************************************************************************************
+ */
+
+#ifndef __HOST_FF_H
+#define __HOST_FF_H
+
+typedef struct
+{
+    int dummy;
+} FIL;
+
+#endif
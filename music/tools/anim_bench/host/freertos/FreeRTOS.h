@@ -0,0 +1,30 @@
+/**
+ ****************************************************************************************************
+ * @file        FreeRTOS.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       主机端模拟:FreeRTOS基本定义(只包含LCD驱动用到的部分)
+ ****************************************************************************************************
+ */
+
+#ifndef __HOST_FREERTOS_H
+#define __HOST_FREERTOS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef int portMUX_TYPE;                   /* 主机端单线程,临界区不需要自旋锁 */
+
+#define portMAX_DELAY           0xFFFFFFFF
+#define portTICK_PERIOD_MS      10
+#define pdMS_TO_TICKS(ms)       ((TickType_t)(ms) / portTICK_PERIOD_MS)
+#define pdFALSE                 0
+#define pdTRUE                  1
+#define pdPASS                  pdTRUE
+#define portMUX_INITIALIZER_UNLOCKED    0
+
+#endif
@@ -0,0 +1,23 @@
+/**
+ ****************************************************************************************************
+ * @file        queue.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       主机端模拟:FreeRTOS消息队列(只有声明,用到的程序自行实现)
+ ****************************************************************************************************
+ */
+
+#ifndef __HOST_QUEUE_H
+#define __HOST_QUEUE_H
+
+#include "freertos/FreeRTOS.h"
+
+
+typedef struct host_queue *QueueHandle_t;
+
+QueueHandle_t xQueueCreate(UBaseType_t len, UBaseType_t item_size);
+void vQueueDelete(QueueHandle_t queue);
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks);
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks);
+
+#endif
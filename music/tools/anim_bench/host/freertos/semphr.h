@@ -0,0 +1,31 @@
+/**
+ ****************************************************************************************************
+ * @file        semphr.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       主机端模拟:FreeRTOS信号量(主机端单线程,总能立即取得)
+ ****************************************************************************************************
+ */
+
+#ifndef __HOST_SEMPHR_H
+#define __HOST_SEMPHR_H
+
+#include "freertos/FreeRTOS.h"
+
+
+typedef void *SemaphoreHandle_t;
+
+static inline BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks)
+{
+    (void)sem;
+    (void)ticks;
+    return pdTRUE;
+}
+
+static inline BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    (void)sem;
+    return pdTRUE;
+}
+
+#endif
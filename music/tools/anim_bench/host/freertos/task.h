@@ -0,0 +1,43 @@
+/**
+ ****************************************************************************************************
+ * @file        task.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       主机端模拟:FreeRTOS任务函数
+ *              除vTaskDelay外只有声明,用到的程序(如emotion_check.c)自行实现
+ ****************************************************************************************************
+ */
+
+#ifndef __HOST_TASK_H
+#define __HOST_TASK_H
+
+#include "freertos/FreeRTOS.h"
+
+
+typedef void *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+typedef enum
+{
+    eNoAction = 0,
+    eSetBits,
+    eIncrement,
+    eSetValueWithOverwrite,
+    eSetValueWithoutOverwrite
+} eNotifyAction;
+
+#define taskENTER_CRITICAL(mux)     ((void)(mux))
+#define taskEXIT_CRITICAL(mux)      ((void)(mux))
+
+BaseType_t xTaskCreate(TaskFunction_t func, const char *name, uint32_t stack, void *param, UBaseType_t prio, TaskHandle_t *handle);
+TickType_t xTaskGetTickCount(void);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action);
+BaseType_t xTaskNotifyWait(uint32_t clear_entry, uint32_t clear_exit, uint32_t *value, TickType_t ticks);
+
+static inline void vTaskDelay(TickType_t ticks)
+{
+    (void)ticks;                            /* 主机端不需要等待屏幕上电/复位 */
+}
+
+#endif
@@ -0,0 +1,15 @@
+/**
+ ****************************************************************************************************
+ * @file        sdkconfig.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       主机端模拟:项目配置(除下面的选项外,各模块使用默认值)
+ ****************************************************************************************************
+ */
+
+#ifndef __HOST_SDKCONFIG_H
+#define __HOST_SDKCONFIG_H
+
+#define CONFIG_LCD_FRAME_MEM_INTERNAL_MAX   0       /* 不限制帧缓存占用的内部RAM,基准测试要测帧缓存绘图 */
+
+#endif
@@ -0,0 +1,20 @@
+/**
+ ****************************************************************************************************
+ * @file        text.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       主机端模拟:汉字显示(主机端没有字库分区,由anim_bench.c实现:汉字为空白,字符串只显示ASCII)
+ ****************************************************************************************************
+ */
+
+#ifndef __HOST_TEXT_H
+#define __HOST_TEXT_H
+
+#include <stdint.h>
+#include "lcd.h"
+
+
+void text_get_hz_mat(unsigned char *code, unsigned char *mat, uint8_t size);
+void text_show_string(uint16_t x, uint16_t y, uint16_t width, uint16_t height, char *str, uint8_t size, uint8_t mode, uint32_t color);
+
+#endif
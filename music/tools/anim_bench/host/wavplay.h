@@ -0,0 +1,18 @@
+/**
+ ****************************************************************************************************
+ * @file        wavplay.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       主机端模拟:WAV播放(表情播放只用到播放时钟,用到的程序自行实现)
+ ****************************************************************************************************
+ */
+
+#ifndef __HOST_WAVPLAY_H
+#define __HOST_WAVPLAY_H
+
+#include <stdint.h>
+
+
+uint8_t wav_get_clock(int64_t *us);
+
+#endif
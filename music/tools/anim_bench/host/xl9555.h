@@ -0,0 +1,26 @@
+/**
+ ****************************************************************************************************
+ * @file        xl9555.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       主机端模拟:XL9555 IO扩展芯片(LCD电源/复位引脚)
+ ****************************************************************************************************
+ */
+
+#ifndef __HOST_XL9555_H
+#define __HOST_XL9555_H
+
+#include <stdint.h>
+
+
+#define SLCD_RST_IO             0x0400
+#define SLCD_PWR_IO             0x0800
+
+static inline uint16_t xl9555_pin_write(uint16_t pin, int val)
+{
+    (void)pin;
+    (void)val;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,280 @@
+/**
+ ****************************************************************************************************
+ * @file        lcd_sim.c
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       主机端LCD模拟器 代码
+ ****************************************************************************************************
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "spi.h"
+#include "lcd.h"
+#include "lcd_sim.h"
+
+
+static uint16_t lcd_sim_gram[LCD_SIM_HEIGHT][LCD_SIM_WIDTH];   /* 模拟显存 */
+static lcd_sim_stats_t lcd_sim_stats;
+static uint8_t lcd_sim_dc = 1;              /* WR引脚:0,命令;1,数据 */
+static uint8_t lcd_sim_cmd = 0;             /* 当前命令 */
+static uint8_t lcd_sim_param[4];            /* 地址参数 */
+static uint8_t lcd_sim_nparam = 0;          /* 已收到的参数字节数 */
+static uint16_t lcd_sim_xs, lcd_sim_xe;     /* 列地址范围 */
+static uint16_t lcd_sim_ys, lcd_sim_ye;     /* 行地址范围 */
+static uint16_t lcd_sim_x, lcd_sim_y;       /* 写显存位置 */
+static int lcd_sim_half = -1;               /* 写显存时未配对的高字节,-1表示没有 */
+static struct spi_device_t { int unused; } lcd_sim_dev;
+static void (*lcd_sim_pre_cb)(spi_transaction_t *trans) = NULL; /* 设备的pre_cb */
+
+/**
+ * @brief       把一个像素写入模拟显存并移动写入位置
+ * @param       color : 像素(RGB565)
+ * @retval      无
+ */
+static void lcd_sim_put(uint16_t color)
+{
+    if (lcd_sim_x < LCD_SIM_WIDTH && lcd_sim_y < LCD_SIM_HEIGHT)
+    {
+        lcd_sim_gram[lcd_sim_y][lcd_sim_x] = color;
+    }
+
+    if (++lcd_sim_x > lcd_sim_xe)
+    {
+        lcd_sim_x = lcd_sim_xs;
+
+        if (++lcd_sim_y > lcd_sim_ye)
+        {
+            lcd_sim_y = lcd_sim_ys;
+        }
+    }
+}
+
+/**
+ * @brief       处理一次数据传输
+ * @param       data : 数据
+ * @param       len  : 长度
+ * @retval      无
+ */
+static void lcd_sim_data(const uint8_t *data, int len)
+{
+    int i;
+
+    lcd_sim_stats.transactions++;
+    lcd_sim_stats.bytes += len;
+
+    if (lcd_sim_dc == 0)                                        /* WR为低时发出的都是命令 */
+    {
+        for (i = 0; i < len; i++)
+        {
+            lcd_sim_cmd = data[i];
+            lcd_sim_nparam = 0;
+            lcd_sim_stats.cmds++;
+
+            if (lcd_sim_cmd == 0x2C)
+            {
+                lcd_sim_x = lcd_sim_xs;
+                lcd_sim_y = lcd_sim_ys;
+                lcd_sim_half = -1;
+                lcd_sim_stats.windows++;
+            }
+        }
+
+        return;
+    }
+
+    if (lcd_sim_cmd == 0x2C)
+    {
+        lcd_sim_stats.pixel_bytes += len;
+
+        for (i = 0; i < len; i++)
+        {
+            if (lcd_sim_half < 0)
+            {
+                lcd_sim_half = data[i];
+            }
+            else
+            {
+                lcd_sim_put((uint16_t)((lcd_sim_half << 8) | data[i]));     /* 高字节在前 */
+                lcd_sim_half = -1;
+            }
+        }
+
+        return;
+    }
+
+    for (i = 0; i < len && lcd_sim_nparam < 4; i++)
+    {
+        lcd_sim_param[lcd_sim_nparam++] = data[i];
+    }
+
+    if (lcd_sim_nparam == 4 && (lcd_sim_cmd == 0x2A || lcd_sim_cmd == 0x2B))
+    {
+        if (lcd_sim_cmd == 0x2A)
+        {
+            lcd_sim_xs = (lcd_sim_param[0] << 8) | lcd_sim_param[1];
+            lcd_sim_xe = (lcd_sim_param[2] << 8) | lcd_sim_param[3];
+        }
+        else
+        {
+            lcd_sim_ys = (lcd_sim_param[0] << 8) | lcd_sim_param[1];
+            lcd_sim_ye = (lcd_sim_param[2] << 8) | lcd_sim_param[3];
+        }
+    }
+}
+
+esp_err_t gpio_config(const gpio_config_t *cfg)
+{
+    (void)cfg;
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level)
+{
+    if (gpio_num == LCD_NUM_WR && lcd_sim_dc != (level ? 1 : 0))
+    {
+        lcd_sim_dc = level ? 1 : 0;
+        lcd_sim_stats.dc_toggles++;
+    }
+
+    return ESP_OK;
+}
+
+/**
+ * @brief       执行一次传输:与SPI驱动一样先调用设备的pre_cb(由它按user字段设置WR引脚),再发送数据
+ * @param       t : 传输描述
+ * @retval      无
+ */
+static void lcd_sim_trans(spi_transaction_t *t)
+{
+    if (lcd_sim_pre_cb)
+    {
+        lcd_sim_pre_cb(t);
+    }
+
+    lcd_sim_data((t->flags & SPI_TRANS_USE_TXDATA) ? t->tx_data : (const uint8_t *)t->tx_buffer, t->length / 8);
+}
+
+esp_err_t spi_bus_add_device(spi_host_device_t host, const spi_device_interface_config_t *dev_config, spi_device_handle_t *handle)
+{
+    (void)host;
+    lcd_sim_pre_cb = dev_config->pre_cb;
+    *handle = &lcd_sim_dev;
+    return ESP_OK;
+}
+
+void spi2_write_cmd(spi_device_handle_t handle, uint8_t cmd)
+{
+    spi_transaction_t t = {0};
+
+    (void)handle;
+    t.length = 8;
+    t.tx_buffer = &cmd;
+    t.user = SPI2_USER_CMD;
+    lcd_sim_trans(&t);
+}
+
+void spi2_write_data(spi_device_handle_t handle, const uint8_t *data, int len)
+{
+    spi_transaction_t t = {0};
+
+    (void)handle;
+
+    if (len == 0)
+    {
+        return;
+    }
+
+    t.length = len * 8;
+    t.tx_buffer = data;
+    t.user = SPI2_USER_DATA;
+    lcd_sim_trans(&t);
+}
+
+void spi2_queue_data(spi_device_handle_t handle, spi_transaction_t *t, const uint8_t *data, int len)
+{
+    memset(t, 0, sizeof(spi_transaction_t));
+    t->length = len * 8;
+    t->tx_buffer = data;
+    t->user = SPI2_USER_DATA;
+    spi2_queue_trans(handle, t);
+}
+
+void spi2_queue_trans(spi_device_handle_t handle, spi_transaction_t *t)
+{
+    (void)handle;
+    lcd_sim_stats.queued++;
+    lcd_sim_trans(t);                                           /* 主机端立即"发送完成" */
+}
+
+spi_transaction_t *spi2_wait_trans(spi_device_handle_t handle)
+{
+    (void)handle;
+    return NULL;
+}
+
+/**
+ * @brief       清零传输统计
+ * @param       无
+ * @retval      无
+ */
+void lcd_sim_reset_stats(void)
+{
+    memset(&lcd_sim_stats, 0, sizeof(lcd_sim_stats));
+}
+
+/**
+ * @brief       获取传输统计
+ * @param       stats : 统计数据
+ * @retval      无
+ */
+void lcd_sim_get_stats(lcd_sim_stats_t *stats)
+{
+    *stats = lcd_sim_stats;
+}
+
+/**
+ * @brief       读取模拟显存中的像素
+ * @param       x, y : 坐标
+ * @retval      像素(RGB565),超出范围时为0
+ */
+uint16_t lcd_sim_pixel(uint16_t x, uint16_t y)
+{
+    return (x < LCD_SIM_WIDTH && y < LCD_SIM_HEIGHT) ? lcd_sim_gram[y][x] : 0;
+}
+
+/**
+ * @brief       保存模拟显存为PPM图片(P6,24位色)
+ * @param       path   : 文件路径
+ * @param       width  : 图片宽度
+ * @param       height : 图片高度
+ * @retval      0,成功;1,失败
+ */
+uint8_t lcd_sim_dump_ppm(const char *path, uint16_t width, uint16_t height)
+{
+    FILE *f = fopen(path, "wb");
+    uint8_t rgb[3];
+    uint16_t c;
+    uint16_t x, y;
+
+    if (f == NULL)
+    {
+        return 1;
+    }
+
+    fprintf(f, "P6\n%u %u\n255\n", width, height);
+
+    for (y = 0; y < height; y++)
+    {
+        for (x = 0; x < width; x++)
+        {
+            c = lcd_sim_pixel(x, y);
+            rgb[0] = ((c >> 11) & 0x1F) * 255 / 31;
+            rgb[1] = ((c >> 5) & 0x3F) * 255 / 63;
+            rgb[2] = (c & 0x1F) * 255 / 31;
+            fwrite(rgb, 1, 3, f);
+        }
+    }
+
+    return fclose(f) == 0 ? 0 : 1;
+}
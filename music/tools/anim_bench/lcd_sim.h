@@ -0,0 +1,40 @@
+/**
+ ****************************************************************************************************
+ * @file        lcd_sim.h
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       主机端LCD模拟器 代码
+ *              代替SPI驱动(spi.c)接收LCD驱动(lcd.c)发出的命令和数据:按WR引脚电平区分命令/数据,
+ *              解析列/行地址设置(0x2A/0x2B)和写显存(0x2C),把像素写入模拟显存,
+ *              同时统计SPI传输次数、字节数和窗口设置次数,可把模拟显存保存为PPM图片
+ ****************************************************************************************************
+ */
+
+#ifndef __LCD_SIM_H
+#define __LCD_SIM_H
+
+#include <stdint.h>
+
+
+#define LCD_SIM_WIDTH           320         /* 模拟显存宽度(取屏幕长边) */
+#define LCD_SIM_HEIGHT          320         /* 模拟显存高度 */
+
+/* 传输统计 */
+typedef struct
+{
+    uint32_t transactions;                  /* SPI传输次数(轮询+队列) */
+    uint32_t queued;                        /* 其中以DMA队列方式提交的次数 */
+    uint32_t bytes;                         /* 发送的字节数 */
+    uint32_t pixel_bytes;                   /* 其中写入显存的字节数 */
+    uint32_t cmds;                          /* 命令数 */
+    uint32_t windows;                       /* 窗口设置次数(写显存命令数) */
+    uint32_t dc_toggles;                    /* WR(命令/数据)引脚电平切换次数 */
+} lcd_sim_stats_t;
+
+/* 函数声明 */
+void lcd_sim_reset_stats(void);                                             /* 清零传输统计 */
+void lcd_sim_get_stats(lcd_sim_stats_t *stats);                             /* 获取传输统计 */
+uint16_t lcd_sim_pixel(uint16_t x, uint16_t y);                             /* 读取模拟显存中的像素(RGB565) */
+uint8_t lcd_sim_dump_ppm(const char *path, uint16_t width, uint16_t height);   /* 保存模拟显存为PPM图片 */
+
+#endif
@@ -0,0 +1,129 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+动画分区打包工具(主机端)
+
+把若干ANIM动画包(.anm,由 anim_pack.py 生成)合并为一个动画集(格式见 components/ANIM/anim.h),
+烧录到Flash的 anim 数据分区后,固件通过 esp_partition_mmap 直接按地址访问,也可直接嵌入固件。
+包名取文件名(不含扩展名),如 sad_loop.anm -> "sad_loop"。
+
+各包的包头/帧索引表/调色板依次排列,帧数据统一放在后面的共享帧数据区,
+编码方式、尺寸、调色板和帧数据都相同的帧(如各序列共用的首帧)按内容哈希去重,只存一份。
+
+示例:
+  python anim_bundle.py -o anim.bin build/anim/*.anm
+  parttool.py --port COMx write_partition --partition-name=anim --input=anim.bin
+"""
+
+import argparse
+import hashlib
+import os
+import struct
+import sys
+
+BUNDLE_MAGIC = b'ANMB'
+BUNDLE_VERSION = 1
+BUNDLE_HEADER_SIZE = 16
+BUNDLE_ENTRY_SIZE = 32
+BUNDLE_NAME_SIZE = 24
+
+ANIM_HEADER_SIZE = 16
+ANIM_FRAME_ENTRY_SIZE = 8
+ANIM_FRAME_META_SIZE = 4
+ANIM_FLAG_LOOP = 0x0001
+
+
+def align4(n):
+    return (n + 3) & ~3
+
+
+def split_pack(name, data):
+    """拆分动画包,返回(包头, 帧信息表+调色板, 帧列表, 去重键)"""
+    if data[:4] != b'ANIM':
+        raise ValueError('%s: 不是ANIM动画包' % name)
+
+    codec, flags, width, height, frame_count, palette_count = struct.unpack('<BHHHHH', data[5:16])
+    entries = frame_count + (1 if flags & ANIM_FLAG_LOOP else 0)
+    table_end = ANIM_HEADER_SIZE + entries * ANIM_FRAME_ENTRY_SIZE
+    meta_end = table_end + entries * ANIM_FRAME_META_SIZE
+    palette = data[meta_end:meta_end + palette_count * 2]
+    frames = []
+
+    for i in range(entries):
+        offset, size = struct.unpack('<II', data[ANIM_HEADER_SIZE + i * 8:ANIM_HEADER_SIZE + i * 8 + 8])
+        frames.append(data[offset:offset + size])
+
+    key = struct.pack('<BHH', codec, width, height) + palette      # 只有解码结果相同时才共享
+    return data[:ANIM_HEADER_SIZE], data[table_end:meta_end] + palette, frames, key
+
+
+def build_bundle(packs, dedupe=True):
+    """packs: [(名字, 包数据)],返回(动画集, 帧总数, 实际保存的帧数)"""
+    split = [(name,) + split_pack(name, data) for name, data in packs]
+
+    heads = bytearray()
+    head_offsets = []
+    base = align4(BUNDLE_HEADER_SIZE + BUNDLE_ENTRY_SIZE * len(packs))
+
+    for name, header, rest, frames, key in split:               # 先排列各包的索引信息,帧表稍后回填
+        raw = name.encode('ascii')
+        if len(raw) >= BUNDLE_NAME_SIZE:
+            raise ValueError('%s: 包名过长(最多%d个字符)' % (name, BUNDLE_NAME_SIZE - 1))
+        head_offsets.append(base + len(heads))
+        heads += header + b'\0' * (len(frames) * ANIM_FRAME_ENTRY_SIZE) + rest
+        heads += b'\0' * (align4(len(heads)) - len(heads))
+
+    store = bytearray()
+    stored = {}
+    store_base = base + len(heads)
+    total_frames = 0
+
+    for (name, header, rest, frames, key), head in zip(split, head_offsets):
+        for i, frame in enumerate(frames):
+            h = hashlib.sha1(key + frame).digest() if dedupe else (name, i)
+            if h not in stored:
+                stored[h] = store_base + len(store)
+                store += frame
+                store += b'\0' * (align4(len(store)) - len(store))
+            pos = head - base + ANIM_HEADER_SIZE + i * ANIM_FRAME_ENTRY_SIZE
+            heads[pos:pos + 8] = struct.pack('<II', stored[h] - head, len(frame))   # 偏移相对包起始
+            total_frames += 1
+
+    total = store_base + len(store)
+    out = bytearray(BUNDLE_MAGIC + struct.pack('<HHII', BUNDLE_VERSION, len(packs), total, 0))
+
+    for (name, _, _, _, _), head in zip(split, head_offsets):
+        out += name.encode('ascii').ljust(BUNDLE_NAME_SIZE, b'\0') + struct.pack('<II', head, total - head)
+
+    out += b'\0' * (base - len(out))
+
+    return bytes(out + heads + store), total_frames, len(stored)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='动画分区打包工具')
+    parser.add_argument('packs', nargs='+', help='动画包(.anm)')
+    parser.add_argument('-o', '--output', required=True, help='输出分区镜像')
+    parser.add_argument('--size', type=lambda s: int(s, 0), help='分区大小,超出时报错')
+    parser.add_argument('--no-dedupe', action='store_true', help='不合并内容相同的帧')
+    args = parser.parse_args()
+
+    packs = []
+    for path in args.packs:
+        name = os.path.splitext(os.path.basename(path))[0]
+        with open(path, 'rb') as f:
+            packs.append((name, f.read()))
+
+    image, frames, unique = build_bundle(packs, dedupe=not args.no_dedupe)
+
+    if args.size is not None and len(image) > args.size:
+        sys.exit('分区镜像 %d 字节,超出分区大小 %d 字节' % (len(image), args.size))
+
+    with open(args.output, 'wb') as f:
+        f.write(image)
+
+    print('%s: %d 个动画包, %d 帧(去重后%d帧), %d 字节' % (args.output, len(packs), frames, unique, len(image)))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,548 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+表情动画打包工具(主机端)
+
+把一组RGB565帧编码为ANIM动画包(格式见 components/ANIM/anim.h),
+可输出二进制包(.anm),也可输出供固件直接编译的 xxx_frames.c/.h。
+固件构建时由BSP的CMakeLists.txt调用本工具,把 assets/emotions/<name>.gif 打包后嵌入固件。
+首帧为关键帧,其余帧只保存相对上一帧变化的脏矩形;--loop 额外生成末帧回到首帧的回环帧。
+颜色不超过256/16种时默认使用整个序列共用的调色板,像素保存为8位/4位索引(--format 可指定)。
+每帧的显示时长记录在帧信息表中,取自GIF的帧延时(--duration 可统一指定)。
+
+帧来源:
+  * PNG图片(8位RGB/RGBA,按命令行顺序作为帧序列)
+  * GIF动画(取其全部帧,可与PNG混合按顺序排列)
+  * 旧版生成的C数组文件(--from-c),按其中 xxx_frames[] 指针表的顺序取帧
+
+示例:
+  python anim_pack.py --from-c sad_in_frames.c --name sad_in --c-out out
+  python anim_pack.py frame0.png frame1.png -o sad_in.anm
+  python anim_pack.py ../assets/emotions/sad_loop.gif --loop -o sad_loop.anm
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+import zlib
+
+ANIM_MAGIC = b'ANIM'
+ANIM_VERSION = 4
+ANIM_CODEC_RLE16 = 1
+ANIM_CODEC_PAL8 = 2
+ANIM_CODEC_PAL4 = 3
+ANIM_HEADER_SIZE = 16
+ANIM_FRAME_ENTRY_SIZE = 8
+ANIM_FRAME_META_SIZE = 4
+
+DEFAULT_DURATION = 100      # 未指定时每帧显示时长(ms)
+
+ANIM_FLAG_LOOP = 0x0001
+ANIM_FRAME_KEY = 0x0001
+
+RECT_OVERHEAD = 128         # 每个矩形的额外开销(设置窗口的5次传输),折算为像素数
+
+
+# --------------------------------------------------------------------------------------------------
+# 帧读取
+# --------------------------------------------------------------------------------------------------
+
+def rgb_to_panel565(r, g, b):
+    """RGB888转RGB565,并交换字节,使其内存布局与面板接收顺序(高字节在前)一致"""
+    v = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3)
+    return ((v & 0xFF) << 8) | (v >> 8)
+
+
+def read_png(path):
+    """读取8位非隔行RGB/RGBA PNG,返回(宽, 高, 像素列表)"""
+    with open(path, 'rb') as f:
+        data = f.read()
+
+    if data[:8] != b'\x89PNG\r\n\x1a\n':
+        raise ValueError('%s: 不是PNG文件' % path)
+
+    pos = 8
+    idat = b''
+    width = height = 0
+    channels = 0
+
+    while pos < len(data):
+        length, ctype = struct.unpack('>I4s', data[pos:pos + 8])
+        body = data[pos + 8:pos + 8 + length]
+        pos += 12 + length
+
+        if ctype == b'IHDR':
+            width, height, depth, color, _, _, interlace = struct.unpack('>IIBBBBB', body)
+            if depth != 8 or color not in (2, 6) or interlace != 0:
+                raise ValueError('%s: 仅支持8位非隔行RGB/RGBA PNG' % path)
+            channels = 3 if color == 2 else 4
+        elif ctype == b'IDAT':
+            idat += body
+        elif ctype == b'IEND':
+            break
+
+    raw = zlib.decompress(idat)
+    stride = width * channels
+    prev = bytearray(stride)
+    pixels = []
+
+    for y in range(height):
+        ftype = raw[y * (stride + 1)]
+        line = bytearray(raw[y * (stride + 1) + 1:(y + 1) * (stride + 1)])
+
+        for x in range(stride):
+            a = line[x - channels] if x >= channels else 0
+            b = prev[x]
+            c = prev[x - channels] if x >= channels else 0
+
+            if ftype == 1:
+                line[x] = (line[x] + a) & 0xFF
+            elif ftype == 2:
+                line[x] = (line[x] + b) & 0xFF
+            elif ftype == 3:
+                line[x] = (line[x] + ((a + b) >> 1)) & 0xFF
+            elif ftype == 4:
+                p = a + b - c
+                pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+                pred = a if (pa <= pb and pa <= pc) else (b if pb <= pc else c)
+                line[x] = (line[x] + pred) & 0xFF
+
+        for x in range(width):
+            o = x * channels
+            pixels.append(rgb_to_panel565(line[o], line[o + 1], line[o + 2]))
+
+        prev = line
+
+    return width, height, pixels
+
+
+def lzw_decode(data, min_size, count):
+    """GIF LZW解码,返回count个索引"""
+    clear = 1 << min_size
+    size = min_size + 1
+    table = [bytes([i]) for i in range(clear)] + [b'', b'']
+    out = bytearray()
+    prev = None
+    bits = nbits = pos = 0
+
+    while len(out) < count:
+        while nbits < size:
+            if pos >= len(data):
+                return out
+            bits |= data[pos] << nbits
+            nbits += 8
+            pos += 1
+
+        code = bits & ((1 << size) - 1)
+        bits >>= size
+        nbits -= size
+
+        if code == clear:
+            size = min_size + 1
+            table = table[:clear + 2]
+            prev = None
+            continue
+        if code == clear + 1:
+            break
+
+        if code < len(table):
+            entry = table[code]
+            if prev is not None:
+                table.append(prev + entry[:1])
+        else:
+            entry = prev + prev[:1]
+            table.append(entry)
+
+        out += entry
+        prev = entry
+
+        if len(table) == (1 << size) and size < 12:
+            size += 1
+
+    return out
+
+
+def read_gif(path):
+    """读取GIF动画(可含多帧),返回(宽, 高, 帧列表, 每帧时长ms);子图按处置方式合成到整幅画布上"""
+    with open(path, 'rb') as f:
+        data = f.read()
+
+    if data[:6] not in (b'GIF87a', b'GIF89a'):
+        raise ValueError('%s: 不是GIF文件' % path)
+
+    width, height, packed, bg, _ = struct.unpack('<HHBBB', data[6:13])
+    pos = 13
+    gct = None
+
+    if packed & 0x80:
+        n = 2 << (packed & 7)
+        gct = [rgb_to_panel565(*data[pos + i * 3:pos + i * 3 + 3]) for i in range(n)]
+        pos += n * 3
+
+    canvas = [gct[bg] if gct else 0] * (width * height)
+    frames = []
+    durations = []
+    transparent = None
+    dispose = 0
+    delay = None
+
+    while pos < len(data):
+        block = data[pos]
+        pos += 1
+
+        if block == 0x21:                                   # 扩展块
+            label = data[pos]
+            pos += 1
+            if label == 0xF9 and data[pos] >= 4:            # 图形控制扩展
+                flags = data[pos + 1]
+                dispose = (flags >> 2) & 7
+                delay = struct.unpack('<H', data[pos + 2:pos + 4])[0] * 10
+                transparent = data[pos + 4] if flags & 1 else None
+            while data[pos]:
+                pos += data[pos] + 1
+            pos += 1
+        elif block == 0x2C:                                 # 图像
+            x0, y0, w, h, flags = struct.unpack('<HHHHB', data[pos:pos + 9])
+            pos += 9
+            table = gct
+            if flags & 0x80:
+                n = 2 << (flags & 7)
+                table = [rgb_to_panel565(*data[pos + i * 3:pos + i * 3 + 3]) for i in range(n)]
+                pos += n * 3
+
+            min_size = data[pos]
+            pos += 1
+            lzw = bytearray()
+            while data[pos]:
+                lzw += data[pos + 1:pos + 1 + data[pos]]
+                pos += data[pos] + 1
+            pos += 1
+
+            idx = lzw_decode(lzw, min_size, w * h)
+            rows = list(range(h))
+            if flags & 0x40:                                # 隔行扫描
+                rows = list(range(0, h, 8)) + list(range(4, h, 8)) + list(range(2, h, 4)) + list(range(1, h, 2))
+
+            saved = list(canvas)
+            for i, y in enumerate(rows):
+                for x in range(w):
+                    v = idx[i * w + x] if i * w + x < len(idx) else 0
+                    if v != transparent and x0 + x < width and y0 + y < height:
+                        canvas[(y0 + y) * width + x0 + x] = table[v]
+
+            frames.append(list(canvas))
+            durations.append(delay if delay else None)          # 0表示未指定
+
+            if dispose == 2:                                # 恢复为背景
+                for y in range(y0, min(y0 + h, height)):
+                    for x in range(x0, min(x0 + w, width)):
+                        canvas[y * width + x] = gct[bg] if gct else 0
+            elif dispose == 3:                              # 恢复为上一帧
+                canvas = saved
+            transparent = None
+            dispose = 0
+            delay = None
+        elif block == 0x3B:                                 # 结束
+            break
+        else:
+            raise ValueError('%s: GIF数据损坏' % path)
+
+    return width, height, frames, durations
+
+
+def read_c_frames(path):
+    """从旧版生成的C文件中读取帧,返回(宽, 高, 帧列表)"""
+    with open(path, 'r') as f:
+        text = f.read()
+
+    arrays = {}
+    for m in re.finditer(r'const\s+uint16_t\s+(\w+)\s*\[[^\]]*\]\s*=\s*\{(.*?)\};', text, re.S):
+        arrays[m.group(1)] = [int(v, 16) for v in re.findall(r'0[xX][0-9A-Fa-f]+', m.group(2))]
+
+    table = re.search(r'const\s+uint16_t\s*\*\s*\w+\s*\[[^\]]*\]\s*=\s*\{(.*?)\};', text, re.S)
+    names = re.findall(r'\w+', table.group(1)) if table else sorted(arrays)
+    frames = [arrays[n] for n in names]
+
+    side = int(len(frames[0]) ** 0.5)
+    if side * side != len(frames[0]):
+        raise ValueError('%s: 无法推断帧尺寸' % path)
+
+    return side, side, frames
+
+
+# --------------------------------------------------------------------------------------------------
+# 编码
+# --------------------------------------------------------------------------------------------------
+
+def rle_encode(values, codec):
+    """游程编码,规则与 anim_decode() 对应;values为RGB565像素或调色板索引"""
+    out = bytearray()
+    literal = []
+
+    def put_values(vals, packed):
+        if codec == ANIM_CODEC_RLE16:
+            for v in vals:
+                out.extend(struct.pack('<H', v))
+        elif codec == ANIM_CODEC_PAL4 and packed:
+            for k in range(0, len(vals), 2):
+                lo = vals[k + 1] if k + 1 < len(vals) else 0
+                out.append((vals[k] << 4) | lo)
+        else:
+            out.extend(bytes(vals))
+
+    def flush_literal():
+        while literal:
+            n = min(len(literal), 128)
+            out.append(n - 1)
+            put_values(literal[:n], True)
+            del literal[:n]
+
+    i = 0
+    total = len(values)
+
+    while i < total:
+        j = i + 1
+        while j < total and values[j] == values[i] and j - i < 16384:
+            j += 1
+        run = j - i
+
+        if run >= 2:
+            flush_literal()
+            if run <= 64:
+                out.append(0x80 | (run - 1))
+            else:
+                out += bytes((0xC0 | ((run - 1) >> 8), (run - 1) & 0xFF))
+            put_values([values[i]], False)
+        else:
+            literal.append(values[i])
+
+        i = j
+
+    flush_literal()
+    return bytes(out)
+
+
+def choose_codec(frames, fmt):
+    """选择编码方式并生成调色板,返回(编码方式, 调色板)"""
+    colors = sorted(set(p for pixels in frames for p in pixels))
+
+    if fmt == 'auto':
+        fmt = 'pal4' if len(colors) <= 16 else ('pal8' if len(colors) <= 256 else 'rgb565')
+
+    if fmt == 'rgb565':
+        return ANIM_CODEC_RLE16, []
+    if fmt == 'pal8' and len(colors) <= 256:
+        return ANIM_CODEC_PAL8, colors
+    if fmt == 'pal4' and len(colors) <= 16:
+        return ANIM_CODEC_PAL4, colors
+
+    raise ValueError('序列共有%d种颜色,无法使用%s格式' % (len(colors), fmt))
+
+
+def bbox(mask, width, x0, y0, x1, y1):
+    """求区域内变化像素的外接矩形,同时返回行/列是否有变化的列表"""
+    rows = [any(mask[y * width + x0:y * width + x1 + 1]) for y in range(y0, y1 + 1)]
+    if not any(rows):
+        return None, rows, None
+    cols = [any(mask[y * width + x] for y in range(y0, y1 + 1)) for x in range(x0, x1 + 1)]
+    ys = [y0 + i for i, r in enumerate(rows) if r]
+    xs = [x0 + i for i, c in enumerate(cols) if c]
+    return (xs[0], ys[0], xs[-1], ys[-1]), rows, cols
+
+
+def widest_gap(flags):
+    """找出最长的连续无变化区间,返回(起点, 长度)"""
+    best = (0, 0)
+    start = None
+    for i, f in enumerate(flags + [True]):
+        if not f and start is None:
+            start = i
+        elif f and start is not None:
+            if i - start > best[1]:
+                best = (start, i - start)
+            start = None
+    return best
+
+
+def split_rects(mask, width, x0, y0, x1, y1):
+    """在最长的空白行/列处递归切分,直到切分不再减少传输量"""
+    box, _, _ = bbox(mask, width, x0, y0, x1, y1)
+    if box is None:
+        return []
+
+    x0, y0, x1, y1 = box
+    _, rows, cols = bbox(mask, width, x0, y0, x1, y1)
+    cost = (x1 - x0 + 1) * (y1 - y0 + 1) + RECT_OVERHEAD
+    rgap = widest_gap(rows)
+    cgap = widest_gap(cols)
+
+    if rgap[1] == 0 and cgap[1] == 0:
+        return [box]
+
+    if rgap[1] * (x1 - x0 + 1) >= cgap[1] * (y1 - y0 + 1):
+        mid = y0 + rgap[0]
+        parts = [(x0, y0, x1, mid - 1), (x0, mid + rgap[1], x1, y1)]
+    else:
+        mid = x0 + cgap[0]
+        parts = [(x0, y0, mid - 1, y1), (mid + cgap[1], y0, x1, y1)]
+
+    children = []
+    for part in parts:
+        children += split_rects(mask, width, *part)
+
+    child_cost = sum((r[2] - r[0] + 1) * (r[3] - r[1] + 1) + RECT_OVERHEAD for r in children)
+    return children if child_cost < cost else [box]
+
+
+def encode_frame(pixels, width, height, prev, codec, lut):
+    """编码一帧;prev为None时生成关键帧,否则生成相对prev的脏矩形帧"""
+    if prev is None:
+        rects = [(0, 0, width - 1, height - 1)]
+        flags = ANIM_FRAME_KEY
+    else:
+        mask = [a != b for a, b in zip(prev, pixels)]
+        rects = split_rects(mask, width, 0, 0, width - 1, height - 1)
+        flags = 0
+
+    out = bytearray(struct.pack('<HH', len(rects), flags))
+
+    for x0, y0, x1, y1 in rects:
+        sub = []
+        for y in range(y0, y1 + 1):
+            sub += pixels[y * width + x0:y * width + x1 + 1]
+        if lut:
+            sub = [lut[p] for p in sub]
+        enc = rle_encode(sub, codec)
+        out += struct.pack('<HHHHI', x0, y0, x1 - x0 + 1, y1 - y0 + 1, len(enc))
+        out += enc
+
+    return bytes(out)
+
+
+def build_pack(width, height, frames, delta=True, loop=False, fmt='auto', durations=None):
+    """生成ANIM动画包;durations为每帧显示时长(ms),None或缺省项取DEFAULT_DURATION"""
+    encoded = []
+    durations = [d or DEFAULT_DURATION for d in (durations or [])]
+    durations += [DEFAULT_DURATION] * (len(frames) - len(durations))
+    codec, palette = choose_codec(frames, fmt)
+    lut = {c: i for i, c in enumerate(palette)}
+
+    for i, pixels in enumerate(frames):
+        if len(pixels) != width * height:
+            raise ValueError('帧尺寸不一致')
+        prev = frames[i - 1] if (delta and i > 0) else None
+        encoded.append(encode_frame(pixels, width, height, prev, codec, lut))
+
+    flags = 0
+    if loop and len(frames) > 1:
+        encoded.append(encode_frame(frames[0], width, height, frames[-1], codec, lut))
+        durations.append(durations[0])                          # 回环帧显示的是首帧
+        flags |= ANIM_FLAG_LOOP
+
+    table = bytearray()
+    meta = bytearray()
+    body = bytearray(struct.pack('<%dH' % len(palette), *palette))
+    body += b'\0' * (-len(body) % 4)
+    data_start = ANIM_HEADER_SIZE + len(encoded) * (ANIM_FRAME_ENTRY_SIZE + ANIM_FRAME_META_SIZE)
+
+    for enc, duration in zip(encoded, durations):
+        meta += struct.pack('<HH', min(duration, 0xFFFF), struct.unpack('<H', enc[2:4])[0])   # 帧标志同帧头
+
+    stored = {}                                                 # 内容相同的帧只存一份
+    for enc in encoded:
+        if enc not in stored:
+            stored[enc] = data_start + len(body)
+            body += enc
+            body += b'\0' * (-len(body) % 4)                    # 每帧4字节对齐
+        table += struct.pack('<II', stored[enc], len(enc))
+
+    header = ANIM_MAGIC + struct.pack('<BBHHHHH', ANIM_VERSION, codec, flags,
+                                      width, height, len(frames), len(palette))
+    return bytes(header + table + meta + body)
+
+
+# --------------------------------------------------------------------------------------------------
+# 输出
+# --------------------------------------------------------------------------------------------------
+
+def write_c(pack, name, width, height, frame_count, outdir):
+    """输出 <name>_frames.c/.h"""
+    guard = '__%s_FRAMES_H__' % name.upper()
+    hpath = os.path.join(outdir, '%s_frames.h' % name)
+    cpath = os.path.join(outdir, '%s_frames.c' % name)
+
+    with open(hpath, 'w', newline='\n') as f:
+        f.write('#ifndef %s\n#define %s\n\n' % (guard, guard))
+        f.write('#include <stdint.h>\n\n')
+        f.write('#define FRAME_WIDTH %d\n#define FRAME_HEIGHT %d\n' % (width, height))
+        f.write('#define %s_FRAME_COUNT %d\n\n' % (name.upper(), frame_count))
+        f.write('extern const uint8_t %s_anim[%d];\n' % (name, len(pack)))
+        f.write('#endif\n')
+
+    with open(cpath, 'w', newline='\n') as f:
+        f.write('#include "%s_frames.h"\n\n' % name)
+        f.write('/* 由 tools/anim_pack.py 生成,请勿手动修改 */\n')
+        f.write('const uint8_t %s_anim[%d] __attribute__((aligned(4))) = {\n' % (name, len(pack)))
+        for i in range(0, len(pack), 16):
+            f.write('    ' + ', '.join('0x%02X' % b for b in pack[i:i + 16]) + ',\n')
+        f.write('};\n')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='表情动画打包工具')
+    parser.add_argument('frames', nargs='*', help='按顺序排列的PNG帧,或GIF动画(取其全部帧)')
+    parser.add_argument('--from-c', help='从旧版生成的C数组文件读取帧')
+    parser.add_argument('-o', '--output', help='输出二进制动画包(.anm)')
+    parser.add_argument('--loop', action='store_true', help='循环序列,额外生成末帧到首帧的回环帧')
+    parser.add_argument('--no-delta', action='store_true', help='所有帧都编码为关键帧')
+    parser.add_argument('--format', choices=('auto', 'rgb565', 'pal8', 'pal4'), default='auto',
+                        help='像素格式,默认按颜色数自动选择')
+    parser.add_argument('--duration', type=int, help='每帧显示时长(ms),默认取GIF中的帧延时,否则%dms' % DEFAULT_DURATION)
+    parser.add_argument('--name', help='C符号前缀,如 sad_in')
+    parser.add_argument('--c-out', help='输出 <name>_frames.c/.h 的目录')
+    args = parser.parse_args()
+
+    durations = None
+
+    if args.from_c:
+        width, height, frames = read_c_frames(args.from_c)
+    elif args.frames:
+        frames = []
+        durations = []
+        width = height = 0
+        for path in args.frames:
+            if path.lower().endswith('.gif'):
+                width, height, pixels, delays = read_gif(path)
+                frames.extend(pixels)
+                durations.extend(delays)
+            else:
+                width, height, pixels = read_png(path)
+                frames.append(pixels)
+                durations.append(None)
+    else:
+        parser.error('需要指定PNG/GIF帧或 --from-c')
+
+    if args.duration:
+        durations = [args.duration] * len(frames)
+
+    pack = build_pack(width, height, frames, delta=not args.no_delta, loop=args.loop, fmt=args.format,
+                      durations=durations)
+    raw = width * height * 2 * len(frames)
+    print('%d帧 %dx%d: %d -> %d 字节 (%.1fx)' % (len(frames), width, height, raw, len(pack), raw / len(pack)))
+
+    if args.output:
+        with open(args.output, 'wb') as f:
+            f.write(pack)
+
+    if args.c_out:
+        if not args.name:
+            parser.error('--c-out 需要同时指定 --name')
+        write_c(pack, args.name, width, height, len(frames), args.c_out)
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())